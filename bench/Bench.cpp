@@ -0,0 +1,49 @@
+#include "Bench.hpp"
+#include <SDL3/SDL.h>
+#include <cstdio>
+#include <format>
+Bench::Result &Bench::report(const std::string &name, uint64_t iterations,
+                             double nsPerOp, double opsPerSec) {
+  auto &result = _results.emplace_back();
+  result.name = name;
+  result.iterations = iterations;
+  result.nsPerOp = nsPerOp;
+  result.opsPerSec = opsPerSec;
+  fprintf(stderr, "%-32s %14.1f ns/op %16.1f ops/s\n", name.c_str(), nsPerOp,
+          opsPerSec);
+  return result;
+}
+
+bool Bench::write(const std::string &path) const {
+  std::string output = "{\n";
+  std::format_to(std::back_inserter(output),
+                 "  \"platform\": \"{}\",\n  \"timestamp\": {},\n"
+                 "  \"results\": [",
+                 SDL_GetPlatform(),
+                 std::chrono::duration_cast<std::chrono::seconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count());
+  for (size_t index = 0; index < _results.size(); ++index) {
+    auto &result = _results[index];
+    std::format_to(std::back_inserter(output),
+                   "{}\n    {{\"name\": \"{}\", \"iterations\": {}, "
+                   "\"ns_per_op\": {:.3f}, \"ops_per_sec\": {:.3f}",
+                   index ? "," : "", result.name, result.iterations,
+                   result.nsPerOp, result.opsPerSec);
+    for (auto &[key, value] : result.metrics) {
+      std::format_to(std::back_inserter(output), ", \"{}\": {:.3f}", key,
+                     value);
+    }
+    output += "}";
+  }
+  output += "\n  ]\n}\n";
+  auto file = path.empty() ? stdout : fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = fwrite(output.data(), 1, output.size(), file) == output.size();
+  if (file != stdout) {
+    ok = fclose(file) == 0 && ok;
+  }
+  return ok;
+}
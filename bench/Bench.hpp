@@ -0,0 +1,90 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/RenderSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+class Bench : public Object {
+public:
+  struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0;
+    double opsPerSec = 0;
+    std::vector<std::pair<std::string, double>> metrics;
+  };
+
+private:
+  std::vector<Result> _results;
+  std::string _filter;
+  double _minTime = 0.2;
+  uint32_t _samples = 5;
+  RenderSystem *_renderSystem = nullptr;
+
+private:
+  static inline double seconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+  }
+
+public:
+  inline const std::vector<Result> &getResults() const { return _results; }
+  inline void setFilter(const std::string &filter) { _filter = filter; }
+  inline void setMinTime(double seconds) { _minTime = seconds; }
+  inline RenderSystem *getRenderSystem() const { return _renderSystem; }
+  inline void setRenderSystem(RenderSystem *renderSystem) {
+    _renderSystem = renderSystem;
+  }
+  inline bool isSelected(const std::string &name) const {
+    return _filter.empty() || name.find(_filter) != std::string::npos;
+  }
+
+  // Runs `fn` in batches until a batch takes long enough to time reliably,
+  // then reports the median of several batches. Each call of `fn` counts as
+  // `opsPerCall` operations.
+  template <class Fn>
+  Result *measure(const std::string &name, Fn &&fn, double opsPerCall = 1) {
+    if (!isSelected(name)) {
+      return nullptr;
+    }
+    uint64_t iterations = 1;
+    for (;;) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        fn();
+      }
+      auto elapsed = seconds(std::chrono::steady_clock::now() - start);
+      if (elapsed >= _minTime / _samples || iterations >= (1ull << 40)) {
+        break;
+      }
+      iterations *= elapsed > 0 ? std::clamp<uint64_t>(static_cast<uint64_t>(
+                                      _minTime / _samples / elapsed),
+                                                  2, 10)
+                                : 10;
+    }
+    std::vector<double> samples;
+    for (uint32_t sample = 0; sample < _samples; ++sample) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        fn();
+      }
+      samples.push_back(seconds(std::chrono::steady_clock::now() - start));
+    }
+    std::sort(samples.begin(), samples.end());
+    auto median = samples[samples.size() / 2];
+    auto ops = iterations * opsPerCall;
+    return &report(name, iterations, median * 1e9 / ops, ops / median);
+  }
+  Result &report(const std::string &name, uint64_t iterations, double nsPerOp,
+                 double opsPerSec);
+  bool write(const std::string &path) const;
+};
+
+void benchRender(Bench &bench);
+void benchData(Bench &bench);
+void benchLogger(Bench &bench);
+void benchScope(Bench &bench);
+void benchSave(Bench &bench);
@@ -0,0 +1,284 @@
+#include "Bench.hpp"
+#include "core/Buffer.hpp"
+#include "core/BufferPool.hpp"
+#include "core/PixelKernels.hpp"
+#include "core/Variable.hpp"
+#include "runtime/AssetManager.hpp"
+#include "runtime/JsonLoader.hpp"
+#include "runtime/LocaleManager.hpp"
+#include "world/TileChunk.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <random>
+#include <toml++/toml.hpp>
+#include <vector>
+static void benchAssets(Bench &bench) {
+  AssetManager assetManager;
+  std::vector<std::string> names;
+  for (uint32_t ns = 0; ns < 16; ++ns) {
+    for (uint32_t index = 0; index < 128; ++index) {
+      auto name = std::format("bench.group{}.asset{}", ns, index);
+      assetManager.store(name, std::make_shared<Buffer>());
+      names.push_back(name);
+    }
+  }
+  size_t index = 0;
+  bench.measure("asset.query", [&] {
+    auto &asset = assetManager.query(names[index++ % names.size()]);
+    if (!asset) {
+      std::abort();
+    }
+  });
+}
+
+static void benchBuffers(Bench &bench) {
+  std::vector<uint8_t> source(16 * 1024, 1);
+  // the pattern of JsonLoader and friends: a fresh buffer per file
+  bench.measure("buffer.operator_new", [&] {
+    auto data = ::operator new(source.size());
+    memcpy(data, source.data(), source.size());
+    ::operator delete(data);
+  });
+  auto before = BufferPool::getStats();
+  auto result = bench.measure("buffer.pooled", [&] {
+    Buffer buffer;
+    buffer.reset(source.size(), source.data());
+  });
+  if (result) {
+    auto stats = BufferPool::getStats();
+    auto hits = stats.hits - before.hits;
+    auto total = hits + stats.misses - before.misses;
+    result->metrics.push_back({"hit_rate", total ? double(hits) / total : 0});
+  }
+  bench.measure("buffer.append", [&] {
+    Buffer buffer;
+    for (size_t offset = 0; offset < source.size(); offset += 256) {
+      buffer.append(source.data() + offset, 256);
+    }
+  });
+}
+
+static void benchVariable(Bench &bench) {
+  bench.measure("variable.construct", [] {
+    Variable root;
+    root.setObject();
+    root.setField("name", Variable().setString("thaumic"));
+    root.setField("enabled", Variable().setBoolean(true));
+    root.setField("scale", Variable().setNumber(1.5f));
+    Variable values;
+    values.setArray();
+    for (int index = 0; index < 16; ++index) {
+      values.push(Variable().setNumber(index));
+    }
+    root.setField("values", values);
+  });
+}
+
+static void benchParsers(Bench &bench) {
+  std::string json = "{\"items\": [";
+  std::string toml;
+  for (int index = 0; index < 500; ++index) {
+    std::format_to(std::back_inserter(json),
+                   "{}{{\"id\": {}, \"name\": \"item{}\", \"stack\": 64, "
+                   "\"tags\": [\"a\", \"b\"], \"enabled\": true}}",
+                   index ? "," : "", index, index);
+    std::format_to(std::back_inserter(toml),
+                   "[item{}]\nid = {}\nname = \"item{}\"\nstack = 64\n"
+                   "tags = [\"a\", \"b\"]\nenabled = true\n\n",
+                   index, index, index);
+  }
+  json += "]}";
+  auto path = (std::filesystem::temp_directory_path() / "thaumic_bench.json")
+                  .string();
+  auto file = SDL_IOFromFile(path.c_str(), "w");
+  if (file) {
+    SDL_WriteIO(file, json.data(), json.size());
+    SDL_CloseIO(file);
+    JsonLoader loader;
+    auto result = bench.measure("json.load", [&] {
+      if (!loader.load(path)) {
+        std::abort();
+      }
+    });
+    if (result) {
+      result->metrics.push_back(
+          {"mb_per_sec", json.size() * result->opsPerSec / 1e6});
+    }
+    std::filesystem::remove(path);
+  }
+  auto result = bench.measure("toml.parse", [&] {
+    auto table = toml::parse(toml);
+    if (table.empty()) {
+      std::abort();
+    }
+  });
+  if (result) {
+    result->metrics.push_back(
+        {"mb_per_sec", toml.size() * result->opsPerSec / 1e6});
+  }
+}
+
+static void benchLocale(Bench &bench) {
+  LocaleManager localeManager;
+  std::string source;
+  for (int index = 0; index < 1000; ++index) {
+    std::format_to(std::back_inserter(source),
+                   "bench.key{} = \"Value {} of {{count}} items\"\n", index,
+                   index);
+  }
+  localeManager.addLocales(source, "bench");
+  int index = 0;
+  bench.measure("locale.i18n", [&] {
+    localeManager.i18n(std::format("bench.key{}", index++ % 1000));
+  });
+  std::unordered_map<std::string, std::string> options = {{"count", "42"}};
+  bench.measure("locale.i18n.options", [&] {
+    localeManager.i18n(std::format("bench.key{}", index++ % 1000), options);
+  });
+}
+
+// Reads or writes every tile of a chunk once per call, in `order`.
+static void benchChunkAccess(Bench &bench, const std::string &name,
+                             TileChunk &chunk, std::vector<uint32_t> &flat,
+                             const std::vector<uint32_t> &order) {
+  uint64_t sum = 0;
+  auto result = bench.measure(
+      std::format("chunk.get.{}", name),
+      [&] {
+        for (auto index : order) {
+          sum += chunk.getTile(index % TileChunk::SIZE,
+                               index / TileChunk::SIZE);
+        }
+      },
+      TileChunk::AREA);
+  if (result) {
+    result->metrics.push_back(
+        {"bytes", static_cast<double>(chunk.getMemoryUsage())});
+  }
+  result = bench.measure(
+      std::format("chunk.get.{}.flat", name),
+      [&] {
+        for (auto index : order) {
+          sum += flat[index];
+        }
+      },
+      TileChunk::AREA);
+  if (result) {
+    result->metrics.push_back(
+        {"bytes", static_cast<double>(flat.size() * sizeof(uint32_t))});
+  }
+  if (sum == 0) {
+    std::abort();
+  }
+  // each pass rotates the tiles by one, so the set of tiles and with it the
+  // encoding stays the same
+  auto tiles = flat;
+  uint32_t shift = 0;
+  bench.measure(
+      std::format("chunk.set.{}", name),
+      [&] {
+        ++shift;
+        for (auto index : order) {
+          chunk.setTile(index % TileChunk::SIZE, index / TileChunk::SIZE,
+                        tiles[(index + shift) % TileChunk::AREA]);
+        }
+      },
+      TileChunk::AREA);
+  shift = 0;
+  bench.measure(
+      std::format("chunk.set.{}.flat", name),
+      [&] {
+        ++shift;
+        for (auto index : order) {
+          flat[index] = tiles[(index + shift) % TileChunk::AREA];
+        }
+      },
+      TileChunk::AREA);
+}
+
+static void benchChunks(Bench &bench) {
+  std::mt19937 random(4);
+  std::vector<uint32_t> sequential(TileChunk::AREA);
+  for (uint32_t index = 0; index < TileChunk::AREA; ++index) {
+    sequential[index] = index;
+  }
+  auto shuffled = sequential;
+  std::shuffle(shuffled.begin(), shuffled.end(), random);
+  struct Case {
+    const char *name;
+    uint32_t kinds;
+  };
+  for (auto [name, kinds] : {Case{"uniform", 1}, Case{"palette", 6},
+                             Case{"direct", TileChunk::AREA}}) {
+    TileChunk chunk;
+    std::vector<uint32_t> flat(TileChunk::AREA);
+    for (uint32_t y = 0; y < TileChunk::SIZE; ++y) {
+      for (uint32_t x = 0; x < TileChunk::SIZE; ++x) {
+        // palette tiles come in short runs like real terrain
+        auto tile = kinds == 1
+                        ? 1
+                        : 1 + (kinds < 16 ? (x / 4 + y) : random()) % kinds;
+        chunk.setTile(x, y, tile);
+        flat[y * TileChunk::SIZE + x] = tile;
+      }
+    }
+    chunk.compact();
+    std::vector<uint8_t> memory(TileChunk::AREA * 8);
+    size_t size = 0;
+    auto encode = bench.measure(std::format("chunk.encode.{}", name), [&] {
+      auto io = SDL_IOFromMem(memory.data(), memory.size());
+      chunk.write(io);
+      size = SDL_TellIO(io);
+      SDL_CloseIO(io);
+    });
+    if (encode) {
+      encode->metrics.push_back({"bytes", static_cast<double>(size)});
+    }
+    TileChunk decoded;
+    bench.measure(std::format("chunk.decode.{}", name), [&] {
+      auto io = SDL_IOFromMem(memory.data(), size);
+      decoded.read(io);
+      SDL_CloseIO(io);
+    });
+    benchChunkAccess(bench, std::format("seq.{}", name), chunk, flat,
+                     sequential);
+    benchChunkAccess(bench, std::format("random.{}", name), chunk, flat,
+                     shuffled);
+  }
+}
+
+static void benchPixels(Bench &bench) {
+  constexpr size_t PIXELS = 1024 * 1024;
+  std::vector<uint32_t> source(PIXELS);
+  std::vector<uint32_t> target(PIXELS);
+  for (size_t index = 0; index < PIXELS; ++index) {
+    source[index] = static_cast<uint32_t>(index * 2654435761u);
+  }
+  auto swizzle = bench.measure(
+      "pixels.swizzle",
+      [&] { swizzleRedBlue(source.data(), target.data(), PIXELS); }, PIXELS);
+  if (swizzle) {
+    swizzle->metrics.push_back({"mb_per_sec", swizzle->opsPerSec * 4 / 1e6});
+  }
+  auto premultiply = bench.measure(
+      "pixels.premultiply",
+      [&] { premultiplyAlpha(source.data(), target.data(), PIXELS); }, PIXELS);
+  if (premultiply) {
+    premultiply->metrics.push_back(
+        {"mb_per_sec", premultiply->opsPerSec * 4 / 1e6});
+  }
+}
+
+void benchData(Bench &bench) {
+  benchAssets(bench);
+  benchBuffers(bench);
+  benchVariable(bench);
+  benchParsers(bench);
+  benchLocale(bench);
+  benchChunks(bench);
+  benchPixels(bench);
+}
@@ -0,0 +1,70 @@
+#include "Bench.hpp"
+#include "runtime/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <thread>
+#include <vector>
+static constexpr uint32_t MESSAGES = 100000;
+
+static void benchThroughput(Bench &bench, Logger *logger, uint32_t threads) {
+  auto name = std::format("logger.throughput.{}", threads);
+  if (!bench.isSelected(name)) {
+    return;
+  }
+  std::vector<std::vector<double>> latencies(threads);
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t index = 0; index < threads; ++index) {
+    workers.emplace_back([&, index] {
+      auto &samples = latencies[index];
+      samples.reserve(MESSAGES / threads);
+      for (uint32_t i = 0; i < MESSAGES / threads; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        logger->info("message {} from thread {}: {}", i, index, "payload");
+        samples.push_back(std::chrono::duration<double, std::nano>(
+                              std::chrono::steady_clock::now() - begin)
+                              .count());
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  Logger::flush();
+  auto elapsed = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  std::vector<double> samples;
+  for (auto &values : latencies) {
+    samples.insert(samples.end(), values.begin(), values.end());
+  }
+  std::sort(samples.begin(), samples.end());
+  uint64_t count = samples.size();
+  auto &result = bench.report(name, count, elapsed * 1e9 / count,
+                              count / elapsed);
+  result.metrics.push_back({"caller_p50_ns", samples[count / 2]});
+  result.metrics.push_back({"caller_p99_ns", samples[count * 99 / 100]});
+  result.metrics.push_back({"caller_max_ns", samples.back()});
+}
+
+void benchLogger(Bench &bench) {
+  auto output = std::tmpfile();
+  if (!output) {
+    return;
+  }
+  Logger::setOutput(output);
+  Logger::setPriorities("info");
+  auto logger = Logger::getLogger("Bench");
+  benchThroughput(bench, logger, 1);
+  benchThroughput(bench, logger, 4);
+  uint32_t index = 0;
+  bench.measure("logger.filtered", [&] {
+    logger->debug("filtered message {}: {}", index++, "payload");
+  });
+  Logger::flush();
+  Logger::setOutput(nullptr);
+  Logger::setPriorities("warn");
+  std::fclose(output);
+}
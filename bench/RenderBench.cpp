@@ -0,0 +1,125 @@
+#include "Bench.hpp"
+#include "render/EffectPlayer.hpp"
+#include "render/Fragment.hpp"
+#include "render/TileMap.hpp"
+#include <SDL3/SDL.h>
+#include <format>
+#include <random>
+#include <vector>
+static void createTexture(RenderSystem *renderSystem, const std::string &name,
+                          uint32_t size) {
+  auto texture = renderSystem->createTexture(name, size, size);
+  std::vector<uint32_t> pixels(size * size);
+  for (uint32_t index = 0; index < pixels.size(); ++index) {
+    pixels[index] = 0xff000000 | (index * 2654435761u);
+  }
+  SDL_UpdateTexture(texture, nullptr, pixels.data(), size * sizeof(uint32_t));
+}
+
+static void benchFragments(Bench &bench, RenderSystem *renderSystem) {
+  constexpr size_t COUNT = 10000;
+  std::mt19937 random(1);
+  std::vector<Fragment> fragments(COUNT);
+  uint32_t textures[4];
+  for (uint32_t index = 0; index < 4; ++index) {
+    auto name = std::format("bench.fragment.{}", index);
+    createTexture(renderSystem, name, 64);
+    textures[index] = renderSystem->getTextureHandle(name);
+  }
+  for (auto &fragment : fragments) {
+    fragment.setTexture(textures[random() % 4]);
+    fragment.setRect({static_cast<float>(random() % 1000),
+                      static_cast<float>(random() % 750), 16, 16});
+    fragment.setClipRect({0, 0, 16, 16});
+    fragment.setZIndex(random() % 8);
+    fragment.setLayer(random() % 2);
+  }
+  bench.measure(
+      "render.fragments",
+      [&] {
+        renderSystem->draw(fragments.data(), fragments.size());
+        renderSystem->present();
+      },
+      COUNT);
+}
+
+static void benchEffects(Bench &bench, RenderSystem *renderSystem) {
+  constexpr size_t COUNT = 1000;
+  createTexture(renderSystem, "bench.effect", 960);
+  EffectPlayer player(COUNT);
+  std::vector<std::vector<EffectPlayer::Cell>> frames(10);
+  for (uint16_t frame = 0; frame < frames.size(); ++frame) {
+    frames[frame].push_back({frame, 0, 0});
+    frames[frame].push_back({static_cast<uint16_t>(frame + 1), 8, -8, 0.5f});
+  }
+  auto animation =
+      player.createAnimation(renderSystem, "bench.effect", frames, 50, 192, 5);
+  std::mt19937 random(2);
+  uint64_t ticks = 0;
+  for (size_t index = 0; index < COUNT; ++index) {
+    player.spawn(animation,
+                 {static_cast<float>(random() % 1000),
+                  static_cast<float>(random() % 750)},
+                 ticks, 0, 0, true);
+  }
+  bench.measure(
+      "render.effects.update",
+      [&] {
+        ticks += 16;
+        player.update(ticks);
+      },
+      COUNT);
+  bench.measure(
+      "render.effects.frame",
+      [&] {
+        ticks += 16;
+        player.update(ticks);
+        player.draw(renderSystem);
+        renderSystem->present();
+      },
+      COUNT);
+}
+
+static void benchTileMap(Bench &bench, RenderSystem *renderSystem) {
+  // a 2x2 chunk viewport, larger than the window on purpose
+  constexpr int32_t VIEW = 2 * TileChunk::SIZE * 32;
+  createTexture(renderSystem, "bench.tiles", 256);
+  TileMap map;
+  map.setSize({256, 256});
+  map.setTileSize({32, 32});
+  map.setViewport({0, 0, VIEW, VIEW});
+  auto layer = map.addLayer();
+  layer->setTexture("bench.tiles");
+  std::mt19937 random(3);
+  for (int32_t y = 0; y < 256; ++y) {
+    for (int32_t x = 0; x < 256; ++x) {
+      map.setTile(0, x, y, 1 + random() % 16);
+    }
+  }
+  map.draw(renderSystem);
+  renderSystem->present();
+  bench.measure("render.tilemap.draw", [&] {
+    map.draw(renderSystem);
+    renderSystem->present();
+  });
+  uint32_t tile = 0;
+  bench.measure("render.tilemap.rebuild", [&] {
+    // one edit per visible chunk forces every visible chunk to rebuild
+    tile = tile % 16 + 1;
+    for (int32_t y = 0; y < VIEW / 32; y += TileChunk::SIZE) {
+      for (int32_t x = 0; x < VIEW / 32; x += TileChunk::SIZE) {
+        map.setTile(0, x, y, tile);
+      }
+    }
+    map.draw(renderSystem);
+    renderSystem->present();
+  });
+  map.release(renderSystem);
+}
+
+void benchRender(Bench &bench) {
+  auto renderSystem = bench.getRenderSystem();
+  benchFragments(bench, renderSystem);
+  benchEffects(bench, renderSystem);
+  benchTileMap(bench, renderSystem);
+}
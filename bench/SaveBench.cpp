@@ -0,0 +1,121 @@
+#include "Bench.hpp"
+#include "runtime/SaveReader.hpp"
+#include "runtime/SaveWriter.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <thread>
+// 2048x2048 tiles of blocky terrain with scattered machines, roughly what a
+// developed factory map looks like.
+static std::shared_ptr<TileWorld> makeWorld() {
+  auto world = std::make_shared<TileWorld>();
+  std::mt19937 random(11);
+  for (int32_t y = 0; y < 2048; ++y) {
+    for (int32_t x = 0; x < 2048; ++x) {
+      uint32_t tile = ((x / 16) ^ (y / 12)) % 4 + 1;
+      if (random() % 64 == 0) {
+        tile = 100 + random() % 200;
+      }
+      world->setTile(x, y, tile);
+    }
+  }
+  return world;
+}
+
+void benchSave(Bench &bench) {
+  if (!bench.isSelected("save.snapshot") && !bench.isSelected("save.write") &&
+      !bench.isSelected("save.load.first") &&
+      !bench.isSelected("save.load.full") &&
+      !bench.isSelected("save.delta")) {
+    return;
+  }
+  auto world = makeWorld();
+  auto path =
+      (std::filesystem::temp_directory_path() / "thaumic_bench.sav").string();
+  Variable metadata;
+  metadata.setObject();
+  metadata.setField("name", Variable().setString("bench"));
+  std::vector<Variable> entities(20000);
+  for (size_t index = 0; index < entities.size(); ++index) {
+    entities[index].setObject();
+    entities[index].setField("id", Variable().setNumber(index));
+    entities[index].setField("type", Variable().setString("belt"));
+  }
+  // the main thread's share of an autosave
+  bench.measure("save.snapshot", [&] {
+    auto snapshot = world->snapshot();
+    if (snapshot.chunks.empty()) {
+      std::abort();
+    }
+  });
+  SaveWriter::Stats stats;
+  auto write = bench.measure("save.write", [&] {
+    SaveWriter writer(path);
+    writer.setMetadata(metadata);
+    writer.addLayer(0, *world);
+    writer.setEntities(entities);
+    writer.commit();
+    stats = writer.getStats();
+  });
+  if (write) {
+    write->metrics.push_back({"raw_bytes", double(stats.rawBytes)});
+    write->metrics.push_back({"file_bytes", double(stats.fileBytes)});
+    write->metrics.push_back(
+        {"mb_per_sec", stats.rawBytes * write->opsPerSec / 1e6});
+  }
+  bench.measure("save.load.first", [&] {
+    SaveReader reader;
+    reader.open(path);
+    std::vector<std::shared_ptr<TileWorld>> worlds = {
+        std::make_shared<TileWorld>()};
+    reader.setFocus(32, 32);
+    while (!reader.poll(worlds, 16)) {
+      std::this_thread::yield();
+    }
+  });
+  bench.measure("save.load.full", [&] {
+    SaveReader reader;
+    reader.open(path);
+    std::vector<std::shared_ptr<TileWorld>> worlds = {
+        std::make_shared<TileWorld>()};
+    std::vector<Variable> loaded;
+    reader.readEntities(loaded);
+    reader.finish(worlds);
+  });
+  // autosaves of a mostly static map: one 16x16 build between saves
+  auto deltaPath = path + ".delta";
+  std::mt19937 random(5);
+  world->clearChanges();
+  size_t deltaBytes = 0;
+  size_t deltaSections = 0;
+  uint32_t generation = 0;
+  auto delta = bench.measure("save.delta", [&] {
+    int32_t left = random() % 2032;
+    int32_t top = random() % 2032;
+    for (int32_t y = 0; y < 16; ++y) {
+      for (int32_t x = 0; x < 16; ++x) {
+        world->setTile(left + x, top + y, 400 + (x + y) % 3);
+      }
+    }
+    SaveWriter writer(deltaPath);
+    writer.setGeneration(1, ++generation);
+    writer.setMetadata(metadata);
+    writer.addLayer(0, *world, true);
+    writer.setEntities(entities);
+    writer.commit();
+    deltaBytes += writer.getStats().fileBytes;
+    deltaSections += writer.getStats().sections;
+  });
+  if (delta && generation) {
+    delta->metrics.push_back({"file_bytes", double(deltaBytes) / generation});
+    delta->metrics.push_back(
+        {"sections", double(deltaSections) / generation});
+    if (stats.fileBytes) {
+      delta->metrics.push_back(
+          {"full_ratio", double(deltaBytes) / generation / stats.fileBytes});
+    }
+  }
+  std::filesystem::remove(deltaPath);
+  std::filesystem::remove(path);
+}
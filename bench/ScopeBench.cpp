@@ -0,0 +1,43 @@
+#include "Bench.hpp"
+#include "core/ScopeGuard.hpp"
+#include <cstdint>
+#include <functional>
+// The std::function based guard this header used to provide, kept here as
+// the baseline.
+class FunctionGuard {
+private:
+  std::function<void()> _handle;
+
+public:
+  FunctionGuard(const std::function<void()> &handle) : _handle(handle) {}
+  ~FunctionGuard() { _handle(); }
+};
+
+// Keeps the compiler from folding the guarded work away.
+static volatile uint64_t sink = 0;
+
+void benchScope(Bench &bench) {
+  uint64_t value = 0;
+  bench.measure("scope.function", [&] {
+    FunctionGuard guard([&] { value++; });
+    sink = value;
+  });
+  bench.measure("scope.exit", [&] {
+    ScopeExit guard([&] { value++; });
+    sink = value;
+  });
+  // four references no longer fit std::function's inline storage
+  uint64_t a = 0, b = 0, c = 0;
+  bench.measure("scope.function.large", [&] {
+    FunctionGuard guard([&value, &a, &b, &c] { value += a + b + c + 1; });
+    sink = value;
+  });
+  bench.measure("scope.exit.large", [&] {
+    ScopeExit guard([&value, &a, &b, &c] { value += a + b + c + 1; });
+    sink = value;
+  });
+  bench.measure("scope.fail", [&] {
+    ScopeFail guard([&] { value++; });
+    sink = value;
+  });
+}
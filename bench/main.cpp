@@ -0,0 +1,58 @@
+#include "Bench.hpp"
+#include "render/RenderSystem.hpp"
+#include "runtime/Logger.hpp"
+#include <SDL3/SDL.h>
+#include <memory>
+#include <string>
+// ThaumicBench [--out=results.json] [--filter=render.] [--time=0.2]
+auto main(int argc, char *argv[]) -> int {
+  Bench bench;
+  std::string out;
+  for (int index = 1; index < argc; ++index) {
+    std::string arg = argv[index];
+    if (arg.starts_with("--out=")) {
+      out = arg.substr(6);
+    } else if (arg.starts_with("--filter=")) {
+      bench.setFilter(arg.substr(9));
+    } else if (arg.starts_with("--time=")) {
+      bench.setMinTime(std::stod(arg.substr(7)));
+    }
+  }
+  Logger::setPriorities("warn");
+  SDL_SetLogOutputFunction(Logger::print, nullptr);
+  SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+  if (!SDL_Init(SDL_INIT_VIDEO)) {
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+      SDL_Log("Could not initialize SDL: %s", SDL_GetError());
+      return -1;
+    }
+  }
+  auto window = SDL_CreateWindow("ThaumicBench", 1024, 768, SDL_WINDOW_HIDDEN);
+  auto renderer = window ? SDL_CreateRenderer(window, "software") : nullptr;
+  if (!renderer) {
+    SDL_Log("Could not create software renderer: %s", SDL_GetError());
+    return -1;
+  }
+  {
+    auto renderSystem = std::make_unique<RenderSystem>(renderer);
+    auto missing =
+        renderSystem->createTexture(RenderSystem::MISSING_TEXTURE, 2, 2);
+    uint32_t pixels[] = {0xff000000, 0xffffffff, 0xffffffff, 0xff000000};
+    SDL_UpdateTexture(missing, nullptr, pixels, 2 * sizeof(uint32_t));
+    bench.setRenderSystem(renderSystem.get());
+    benchRender(bench);
+    benchData(bench);
+    benchLogger(bench);
+    benchScope(bench);
+    benchSave(bench);
+    bench.setRenderSystem(nullptr);
+  }
+  SDL_DestroyWindow(window);
+  SDL_Quit();
+  if (!bench.write(out)) {
+    SDL_Log("Could not write results to '%s'", out.c_str());
+    return -1;
+  }
+  return 0;
+}
@@ -1,16 +1,42 @@
 #pragma once
 #include "core/Object.hpp"
 #include <SDL3/SDL.h>
+#include <cstddef>
+// Growable byte buffer backed by BufferPool, so short-lived I/O buffers reuse
+// memory instead of going to the global allocator every time.
 class Buffer : public Object {
 private:
   void *_data{};
   size_t _size{};
+  size_t _capacity{};
+  size_t _alignment{};
+
+private:
+  void reallocate(size_t capacity, bool preserve);
 
 public:
+  Buffer() = default;
+  Buffer(const Buffer &) = delete;
+  Buffer &operator=(const Buffer &) = delete;
+  Buffer(Buffer &&other) noexcept;
+  Buffer &operator=(Buffer &&other) noexcept;
   ~Buffer() override;
   inline size_t getSize() const { return _size; }
+  inline size_t getCapacity() const { return _capacity; }
   inline void *getData() const { return _data; }
+  inline size_t getAlignment() const { return _alignment; }
+  // Applies to the current storage and every later allocation.
+  void setAlignment(size_t alignment);
+  // Sets the size without keeping the old contents, reusing the storage when
+  // it is large enough.
   void reset(size_t size, void *data = nullptr);
-  size_t write(size_t offset, size_t len, void *data);
-  size_t read(size_t offset, size_t len, void *data);
-};
\ No newline at end of file
+  // Sets the size, keeping the contents and zero-filling any new bytes.
+  void resize(size_t size);
+  void reserve(size_t capacity);
+  void append(const void *data, size_t len);
+  inline void clear() { _size = 0; }
+  void shrink();
+  // Writes past the end grow the buffer.
+  size_t write(size_t offset, size_t len, const void *data);
+  size_t read(size_t offset, size_t len, void *data) const;
+};
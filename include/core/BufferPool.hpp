@@ -0,0 +1,43 @@
+#pragma once
+#include "core/Object.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+// Per-thread cache of freed blocks, bucketed into size classes four steps per
+// power of two (at most 25% slack). Blocks may be released on any thread; they
+// join the releasing thread's cache. Larger blocks and alignments above
+// ALIGNMENT go straight to the global allocator.
+class BufferPool : public Object {
+public:
+  static constexpr size_t ALIGNMENT = 64;
+  static constexpr size_t MIN_SIZE = 64;
+  static constexpr size_t MAX_SIZE = 4 * 1024 * 1024;
+  static constexpr size_t MAX_BLOCKS = 8;
+  static constexpr size_t MAX_CACHED = 16 * 1024 * 1024;
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t cached = 0;
+  };
+
+private:
+  static constexpr size_t CLASS_COUNT = 65;
+  std::array<std::vector<void *>, CLASS_COUNT> _classes;
+  Stats _stats;
+
+private:
+  static BufferPool *getPool();
+  static size_t getClass(size_t size);
+  static size_t getClassSize(size_t index);
+
+public:
+  ~BufferPool() override;
+  // Rounds `size` up to its size class and stores the usable size in
+  // `capacity`.
+  static void *allocate(size_t size, size_t alignment, size_t &capacity);
+  static void release(void *data, size_t capacity, size_t alignment);
+  static void trim();
+  static Stats getStats();
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include "core/Buffer.hpp"
+#include "core/Object.hpp"
+#include <SDL3/SDL_iostream.h>
+#include <cstddef>
+// SDL_IOStream adapters over zstd frames, so anything that serializes to an
+// SDL_IOStream can compress and decompress on the fly. Compression contexts
+// are cached per thread.
+class Compression : public Object {
+public:
+  static constexpr int DEFAULT_LEVEL = 3;
+
+public:
+  // Write-only stream appending one zstd frame to `output`. SDL_TellIO
+  // reports the uncompressed bytes written so far; SDL_CloseIO finishes the
+  // frame and fails if compression did.
+  static SDL_IOStream *openWriter(Buffer &output, int level = DEFAULT_LEVEL);
+  // Read-only stream over one zstd frame. `data` must outlive the stream.
+  static SDL_IOStream *openReader(const void *data, size_t size);
+};
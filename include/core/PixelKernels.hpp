@@ -0,0 +1,6 @@
+#pragma once
+#include <cstddef>
+// Kernels over 4-byte pixels whose alpha is the last byte in memory
+// (RGBA32/BGRA32). Source and destination may be the same buffer.
+void swizzleRedBlue(const void *src, void *dst, size_t pixels);
+void premultiplyAlpha(const void *src, void *dst, size_t pixels);
@@ -0,0 +1,90 @@
+#pragma once
+#include "core/Object.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+// Zones and counters are appended to a buffer owned by the calling thread, so
+// recording takes no locks. Names must be string literals: only the pointer
+// is stored until the trace is exported.
+class Profiler : public Object {
+public:
+  static constexpr size_t CHUNK_SIZE = 4096;
+  static constexpr size_t MAX_CHUNKS = 1024;
+
+  class Zone {
+  private:
+    const char *_name = nullptr;
+    uint64_t _start = 0;
+
+  public:
+    inline Zone(const char *name) {
+      if (isEnabled()) {
+        _name = name;
+        _start = now();
+      }
+    }
+    inline ~Zone() {
+      if (_name) {
+        record(_name, 'X', _start, now() - _start);
+      }
+    }
+    Zone(const Zone &) = delete;
+    Zone &operator=(const Zone &) = delete;
+  };
+
+private:
+  struct Event {
+    const char *name;
+    char phase;
+    uint64_t time;
+    int64_t value;
+  };
+  struct ThreadBuffer {
+    uint32_t id = 0;
+    std::string name;
+    std::array<std::atomic<Event *>, MAX_CHUNKS> chunks = {};
+    std::atomic<size_t> count = 0;
+    size_t dropped = 0;
+    ~ThreadBuffer();
+  };
+
+private:
+  static std::atomic<bool> _enabled;
+  static std::mutex _mutex;
+  static std::vector<std::unique_ptr<ThreadBuffer>> _threads;
+
+private:
+  // Threads are only registered once they record something.
+  static ThreadBuffer *getThreadBuffer(bool create = true);
+  static void record(const char *name, char phase, uint64_t time,
+                     int64_t value);
+
+public:
+  static inline bool isEnabled() {
+    return _enabled.load(std::memory_order_relaxed);
+  }
+  static uint64_t now();
+  static void start();
+  static void stop();
+  static void setThreadName(const std::string &name);
+  static inline void counter(const char *name, int64_t value) {
+    if (isEnabled()) {
+      record(name, 'C', now(), value);
+    }
+  }
+  static inline void instant(const char *name) {
+    if (isEnabled()) {
+      record(name, 'i', now(), 0);
+    }
+  }
+  static bool exportTrace(const std::string &path);
+};
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name)                                                     \
+  Profiler::Zone PROFILE_CONCAT(__profileZone, __LINE__)(name)
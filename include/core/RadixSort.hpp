@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+// LSD radix sort on a 64-bit key, 8 bits per pass. Passes where every key
+// shares the same byte are skipped. `buffer` is scratch storage and keeps its
+// capacity across calls; on return `items` holds the sorted sequence.
+template <class T, class KeyFn>
+void radixSort(std::vector<T> &items, std::vector<T> &buffer, KeyFn &&key) {
+  size_t count = items.size();
+  if (count < 2) {
+    return;
+  }
+  std::array<std::array<size_t, 256>, 8> histograms = {};
+  for (auto &item : items) {
+    uint64_t value = key(item);
+    for (size_t pass = 0; pass < 8; ++pass) {
+      histograms[pass][(value >> (pass * 8)) & 0xff]++;
+    }
+  }
+  buffer.resize(count);
+  T *src = items.data();
+  T *dst = buffer.data();
+  for (size_t pass = 0; pass < 8; ++pass) {
+    auto shift = pass * 8;
+    auto &histogram = histograms[pass];
+    if (histogram[(key(src[0]) >> shift) & 0xff] == count) {
+      continue;
+    }
+    size_t offset = 0;
+    for (auto &bucket : histogram) {
+      auto size = bucket;
+      bucket = offset;
+      offset += size;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      dst[histogram[(key(src[i]) >> shift) & 0xff]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  if (src != items.data()) {
+    items.swap(buffer);
+  }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "core/Object.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+// Bounded lock-free queue for many producers and a single consumer. Every
+// cell carries a sequence number: a producer claims a slot by advancing the
+// head and publishes it by bumping the sequence, so the consumer never waits
+// on a half-written cell.
+template <class T> class RingBuffer : public Object {
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+private:
+  std::unique_ptr<Cell[]> _cells;
+  size_t _mask;
+  alignas(64) std::atomic<size_t> _head = 0;
+  alignas(64) size_t _tail = 0;
+
+public:
+  RingBuffer(size_t capacity) {
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+    _cells = std::make_unique<Cell[]>(capacity);
+    _mask = capacity - 1;
+    for (size_t index = 0; index < capacity; ++index) {
+      _cells[index].sequence.store(index, std::memory_order_relaxed);
+    }
+  }
+  inline size_t getCapacity() const { return _mask + 1; }
+  bool push(T &&value) {
+    auto position = _head.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &_cells[position & _mask];
+      auto sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+      if (diff == 0) {
+        if (_head.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = _head.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+  bool pop(T &value) {
+    auto &cell = _cells[_tail & _mask];
+    if (cell.sequence.load(std::memory_order_acquire) != _tail + 1) {
+      return false;
+    }
+    value = std::move(cell.value);
+    cell.sequence.store(_tail + _mask + 1, std::memory_order_release);
+    _tail++;
+    return true;
+  }
+};
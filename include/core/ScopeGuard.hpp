@@ -1,11 +1,74 @@
 #pragma once
-#include <functional>
-class ScopeGuard {
+#include <exception>
+#include <type_traits>
+#include <utility>
+// Runs a callback when the scope ends. The callback is stored inline, so a
+// guard costs no allocation and the call is usually inlined.
+template <class Fn, class Policy> class BasicScopeGuard {
 private:
-  std::function<void()> _handle;
+  Fn _handle;
+  [[no_unique_address]] Policy _policy;
+  bool _active = true;
 
 public:
-  ScopeGuard(const std::function<void()> &handle) : _handle(handle) {}
-  ~ScopeGuard() { _handle(); }
+  template <class F>
+  constexpr explicit BasicScopeGuard(F &&handle) noexcept(
+      std::is_nothrow_constructible_v<Fn, F>)
+      : _handle(std::forward<F>(handle)) {}
+  BasicScopeGuard(const BasicScopeGuard &) = delete;
+  BasicScopeGuard &operator=(const BasicScopeGuard &) = delete;
+  constexpr ~BasicScopeGuard() noexcept {
+    if (_active && _policy.shouldRun()) {
+      _handle();
+    }
+  }
+  constexpr void dismiss() noexcept { _active = false; }
 };
-#define DEFER(cb) ScopeGuard __guard##__LINE__(cb)
\ No newline at end of file
+
+struct ScopeExitPolicy {
+  constexpr bool shouldRun() const { return true; }
+};
+struct ScopeFailPolicy {
+  int exceptions = std::uncaught_exceptions();
+  bool shouldRun() const { return std::uncaught_exceptions() > exceptions; }
+};
+struct ScopeSuccessPolicy {
+  int exceptions = std::uncaught_exceptions();
+  bool shouldRun() const { return std::uncaught_exceptions() <= exceptions; }
+};
+
+// Always runs.
+template <class Fn>
+class ScopeExit : public BasicScopeGuard<Fn, ScopeExitPolicy> {
+public:
+  template <class F>
+  constexpr explicit ScopeExit(F &&handle)
+      : BasicScopeGuard<Fn, ScopeExitPolicy>(std::forward<F>(handle)) {}
+};
+template <class Fn> ScopeExit(Fn) -> ScopeExit<Fn>;
+
+// Runs only when the scope is left by an exception.
+template <class Fn>
+class ScopeFail : public BasicScopeGuard<Fn, ScopeFailPolicy> {
+public:
+  template <class F>
+  explicit ScopeFail(F &&handle)
+      : BasicScopeGuard<Fn, ScopeFailPolicy>(std::forward<F>(handle)) {}
+};
+template <class Fn> ScopeFail(Fn) -> ScopeFail<Fn>;
+
+// Runs only when the scope is left normally.
+template <class Fn>
+class ScopeSuccess : public BasicScopeGuard<Fn, ScopeSuccessPolicy> {
+public:
+  template <class F>
+  explicit ScopeSuccess(F &&handle)
+      : BasicScopeGuard<Fn, ScopeSuccessPolicy>(std::forward<F>(handle)) {}
+};
+template <class Fn> ScopeSuccess(Fn) -> ScopeSuccess<Fn>;
+
+#define SCOPE_CONCAT_IMPL(a, b) a##b
+#define SCOPE_CONCAT(a, b) SCOPE_CONCAT_IMPL(a, b)
+#define DEFER(cb) ScopeExit SCOPE_CONCAT(__guard, __COUNTER__)(cb)
+#define DEFER_FAIL(cb) ScopeFail SCOPE_CONCAT(__guard, __COUNTER__)(cb)
+#define DEFER_SUCCESS(cb) ScopeSuccess SCOPE_CONCAT(__guard, __COUNTER__)(cb)
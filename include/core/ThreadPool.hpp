@@ -0,0 +1,29 @@
+#pragma once
+#include "core/Object.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+class ThreadPool : public Object {
+private:
+  std::vector<std::thread> _workers;
+  std::deque<std::function<void()>> _tasks;
+  std::mutex _mutex;
+  std::condition_variable _ready;
+  std::condition_variable _idle;
+  size_t _active = 0;
+  bool _stopping = false;
+
+private:
+  void work();
+
+public:
+  ThreadPool(size_t threads = 0);
+  ~ThreadPool() override;
+  inline size_t getThreadCount() const { return _workers.size(); }
+  void submit(std::function<void()> task);
+  void wait();
+};
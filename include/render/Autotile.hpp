@@ -0,0 +1,62 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/RenderSystem.hpp"
+#include "runtime/Logger.hpp"
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+class Autotile : public Object {
+public:
+  static constexpr uint32_t VARIANTS = 48;
+  static constexpr uint32_t COLUMNS = 8;
+  static constexpr uint32_t ROWS = VARIANTS / COLUMNS;
+  enum Neighbor : uint8_t {
+    NORTH = 1,
+    NORTH_EAST = 2,
+    EAST = 4,
+    SOUTH_EAST = 8,
+    SOUTH = 16,
+    SOUTH_WEST = 32,
+    WEST = 64,
+    NORTH_WEST = 128,
+  };
+
+private:
+  std::string _texture;
+  uint32_t _tileSize = 0;
+  uint32_t _frameDuration = 400;
+  std::vector<uint32_t> _frames;
+  std::vector<uint16_t> _animations;
+
+  Logger *_logger = Logger::getLogger("Render");
+
+private:
+  void compose(SDL_Surface *source, SDL_Surface *atlas, uint32_t kind,
+               uint32_t frames);
+
+public:
+  static uint8_t getVariant(uint8_t mask);
+  // `tileSize` is the map's tile size. Images at least four tiles high are
+  // complete RMXP autotiles, shorter ones a strip of plain tiles; either is
+  // one frame per frame width.
+  bool build(RenderSystem *renderSystem, const std::string &texture,
+             const std::vector<std::string> &images, uint32_t tileSize);
+  inline const std::string &getTexture() const { return _texture; }
+  inline uint32_t getTileSize() const { return _tileSize; }
+  inline uint32_t getKindCount() const { return _frames.size(); }
+  inline uint32_t getFrameCount(uint32_t kind) const { return _frames[kind]; }
+  inline uint16_t getAnimation(uint32_t kind) const {
+    return _animations[kind];
+  }
+  inline uint32_t getFrameDuration() const { return _frameDuration; }
+  inline void setFrameDuration(uint32_t duration) { _frameDuration = duration; }
+  inline SDL_FRect getClipRect(uint32_t kind, uint8_t variant) const {
+    return {
+        static_cast<float>((variant % COLUMNS) * _tileSize),
+        static_cast<float>((kind * ROWS + variant / COLUMNS) * _tileSize),
+        static_cast<float>(_tileSize),
+        static_cast<float>(_tileSize),
+    };
+  }
+};
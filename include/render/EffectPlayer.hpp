@@ -0,0 +1,78 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/Fragment.hpp"
+#include "render/RenderSystem.hpp"
+#include "runtime/Logger.hpp"
+#include <SDL3/SDL_rect.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+class EffectPlayer : public Object {
+public:
+  struct Cell {
+    uint16_t pattern = 0;
+    float x = 0.f;
+    float y = 0.f;
+    float zoom = 1.f;
+    float angle = 0.f;
+    bool mirror = false;
+    uint8_t opacity = 255;
+    Fragment::Blend blend = Fragment::Blend::NORMAL;
+  };
+
+private:
+  struct Animation {
+    uint32_t texture;
+    float cellSize;
+    uint32_t columns;
+    uint32_t frameDuration;
+    uint32_t firstFrame;
+    uint32_t frameCount;
+  };
+  struct Frame {
+    uint32_t firstCell;
+    uint32_t cellCount;
+  };
+  struct Instance {
+    uint32_t animation;
+    uint64_t start;
+    SDL_FPoint position;
+    int32_t zIndex;
+    uint8_t layer;
+    bool loop;
+    uint32_t generation;
+    uint32_t frame;
+  };
+
+private:
+  std::vector<Animation> _animations;
+  std::vector<Frame> _frames;
+  std::vector<Cell> _cells;
+
+  std::vector<Instance> _instances;
+  std::vector<uint32_t> _active;
+  std::vector<uint32_t> _free;
+  std::vector<Fragment> _fragments;
+
+  Logger *_logger = Logger::getLogger("Render");
+
+public:
+  EffectPlayer(size_t capacity = 1024);
+  uint32_t createAnimation(RenderSystem *renderSystem,
+                           const std::string &texture,
+                           const std::vector<std::vector<Cell>> &frames,
+                           uint32_t frameDuration = 50, uint32_t cellSize = 192,
+                           uint32_t columns = 5);
+  uint64_t spawn(uint32_t animation, const SDL_FPoint &position,
+                 uint64_t ticks, int32_t zIndex = 0, uint8_t layer = 0,
+                 bool loop = false);
+  void stop(uint64_t effect);
+  bool isPlaying(uint64_t effect) const;
+  void setPosition(uint64_t effect, const SDL_FPoint &position);
+  void clear();
+  inline size_t getCapacity() const { return _instances.size(); }
+  inline size_t getActiveCount() const { return _active.size(); }
+  void update(uint64_t ticks);
+  void draw(RenderSystem *renderSystem, const SDL_FPoint &offset = {});
+};
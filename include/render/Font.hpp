@@ -0,0 +1,18 @@
+#pragma once
+#include "core/Buffer.hpp"
+#include "core/Object.hpp"
+#include "runtime/Logger.hpp"
+#include <SDL3_ttf/SDL_ttf.h>
+#include <unordered_map>
+class Font : public Object {
+private:
+  Buffer _data;
+  std::unordered_map<float, TTF_Font *> _fonts;
+
+  Logger *_logger = Logger::getLogger("Font");
+
+public:
+  ~Font() override;
+  inline Buffer &getData() { return _data; }
+  TTF_Font *getFont(float size);
+};
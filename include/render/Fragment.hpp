@@ -1,18 +1,25 @@
 #pragma once
-#include "core/Object.hpp"
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_rect.h>
 #include <SDL3/SDL_surface.h>
-#include <string>
-class Fragment : public Object {
+#include <cstdint>
+#include <type_traits>
+class Fragment {
+public:
+  enum class Blend : uint8_t { NORMAL, ADD, SUBTRACT };
+
 private:
   SDL_FRect _rect = {};
   SDL_FRect _clipRect = {};
   SDL_FPoint _center = {};
   float _angle = 0.f;
-  SDL_FlipMode _mode = SDL_FLIP_NONE;
   int32_t _zIndex = 0;
-  std::string _texture;
+  uint32_t _texture = 0;
+  uint8_t _mode = SDL_FLIP_NONE;
+  uint8_t _layer = 0;
+  uint16_t _animation = 0;
+  SDL_Color _color = {255, 255, 255, 255};
+  Blend _blend = Blend::NORMAL;
 
 public:
   inline const SDL_FRect &getRect() const { return _rect; }
@@ -23,12 +30,33 @@ public:
   inline void setRotateCeneter(const SDL_FPoint &center) { _center = center; }
   inline float getRotateAngle() const { return _angle; }
   inline void setRotateAngle(float angle) { _angle = angle; }
-  inline SDL_FlipMode getFlipMode() const { return _mode; }
-  inline void setFlipMode(SDL_FlipMode mode) { _mode = mode; }
+  inline SDL_FlipMode getFlipMode() const {
+    return static_cast<SDL_FlipMode>(_mode);
+  }
+  inline void setFlipMode(SDL_FlipMode mode) {
+    _mode = static_cast<uint8_t>(mode);
+  }
+  inline bool hasTransform() const {
+    return _angle != 0.f || _mode != SDL_FLIP_NONE;
+  }
+  // The draw list sorts on 16 bits of z: values outside
+  // [Z_MIN, Z_MAX] draw as if they were the nearest bound.
+  static constexpr int32_t Z_MIN = -0x8000;
+  static constexpr int32_t Z_MAX = 0x7fff;
   inline int32_t getZIndex() const { return _zIndex; }
   inline void setZIndex(int32_t zindex) { _zIndex = zindex; }
-  inline const std::string &getTexture() const { return _texture; }
-  inline void setTexture(const std::string &texture) { _texture = texture; }
+  inline uint8_t getLayer() const { return _layer; }
+  inline void setLayer(uint8_t layer) { _layer = layer; }
+  inline uint16_t getAnimation() const { return _animation; }
+  inline void setAnimation(uint16_t animation) { _animation = animation; }
+  inline const SDL_Color &getColor() const { return _color; }
+  inline void setColor(const SDL_Color &color) { _color = color; }
+  inline uint8_t getAlpha() const { return _color.a; }
+  inline void setAlpha(uint8_t alpha) { _color.a = alpha; }
+  inline Blend getBlendMode() const { return _blend; }
+  inline void setBlendMode(Blend blend) { _blend = blend; }
+  inline uint32_t getTexture() const { return _texture; }
+  inline void setTexture(uint32_t texture) { _texture = texture; }
   inline void setPosition(const SDL_FPoint &position) {
     _rect.x = position.x;
     _rect.y = position.y;
@@ -41,4 +69,6 @@ public:
     _center = center;
     _angle = angle;
   }
-};
\ No newline at end of file
+};
+static_assert(std::is_trivially_copyable_v<Fragment>);
+static_assert(sizeof(Fragment) == 64);
@@ -0,0 +1,49 @@
+#pragma once
+#include "core/Object.hpp"
+#include "runtime/Logger.hpp"
+#include <SDL3/SDL_rect.h>
+#include <SDL3_ttf/SDL_ttf.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+class RenderSystem;
+class GlyphAtlas : public Object {
+public:
+  static constexpr int PAGE_SIZE = 1024;
+  static constexpr size_t MAX_PAGES = 8;
+  struct Glyph {
+    uint32_t texture = 0;
+    SDL_FRect clipRect = {};
+    float advance = 0.f;
+  };
+
+private:
+  struct Page {
+    uint32_t texture;
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+  };
+
+private:
+  std::unordered_map<TTF_Font *, std::unordered_map<uint32_t, Glyph>> _glyphs;
+  std::vector<Page> _pages;
+  uint32_t _generation = 1;
+  // every page filled up; cleared once the current frame is presented
+  bool _full = false;
+
+  Logger *_logger = Logger::getLogger("Render");
+
+private:
+  bool allocate(RenderSystem *renderSystem, int w, int h, Page *&page,
+                SDL_Rect &rect);
+
+public:
+  inline uint32_t getGeneration() const { return _generation; }
+  const Glyph *getGlyph(RenderSystem *renderSystem, TTF_Font *font,
+                        uint32_t codepoint);
+  void forget(TTF_Font *font);
+  void clear();
+  // Called between frames, when no submitted fragment refers to the pages.
+  void beginFrame();
+};
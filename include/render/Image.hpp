@@ -1,15 +1,39 @@
 #pragma once
 #include "core/Object.hpp"
 #include <SDL3/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 class Image : public Object {
 private:
   SDL_Surface *_surface = {};
+  std::atomic<bool> _ready = true;
+  bool _premultiplied = false;
+  mutable std::mutex _mutex;
+  mutable std::condition_variable _decoded;
+
+private:
+  void wait() const;
 
 public:
   Image(SDL_Surface *texture = nullptr);
   Image(uint32_t w, uint32_t h, SDL_PixelFormat format = SDL_PIXELFORMAT_RGBA32,
         void *data = nullptr);
   ~Image() override;
-  inline SDL_Surface *getSurface() const { return _surface; }
+  inline bool isReady() const {
+    return _ready.load(std::memory_order_acquire);
+  }
+  inline SDL_Surface *getSurface() const {
+    if (!isReady()) {
+      wait();
+    }
+    return _surface;
+  }
   void setSurface(SDL_Surface *surface);
-};
\ No newline at end of file
+  inline bool isPremultiplied() const { return _premultiplied; }
+  inline void setPremultiplied(bool premultiplied) {
+    _premultiplied = premultiplied;
+  }
+  void beginDecode();
+  void endDecode(SDL_Surface *surface);
+};
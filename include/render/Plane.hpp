@@ -0,0 +1,60 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/Fragment.hpp"
+#include "render/RenderSystem.hpp"
+#include "runtime/Logger.hpp"
+#include <SDL3/SDL_rect.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+class Plane : public Object {
+private:
+  std::string _image;
+  SDL_FRect _viewport = {};
+  SDL_FPoint _origin = {};
+  SDL_FPoint _parallax = {1.f, 1.f};
+  SDL_FPoint _velocity = {};
+  SDL_Color _color = {255, 255, 255, 255};
+  Fragment::Blend _blend = Fragment::Blend::NORMAL;
+  int32_t _zIndex = 0;
+  uint8_t _layer = 0;
+  uint64_t _lastTicks = 0;
+
+  uint32_t _id;
+  uint32_t _cache = 0;
+  std::string _cacheImage;
+  SDL_Point _cacheSize = {};
+  std::vector<Fragment> _fragments;
+
+  Logger *_logger = Logger::getLogger("Render");
+
+private:
+  uint32_t prepareCache(RenderSystem *renderSystem, uint32_t image,
+                        const SDL_Texture *texture);
+
+public:
+  Plane();
+  inline const std::string &getImage() const { return _image; }
+  inline void setImage(const std::string &image) { _image = image; }
+  inline const SDL_FRect &getViewport() const { return _viewport; }
+  inline void setViewport(const SDL_FRect &viewport) { _viewport = viewport; }
+  inline const SDL_FPoint &getOrigin() const { return _origin; }
+  inline void setOrigin(const SDL_FPoint &origin) { _origin = origin; }
+  inline const SDL_FPoint &getParallax() const { return _parallax; }
+  inline void setParallax(const SDL_FPoint &parallax) { _parallax = parallax; }
+  inline const SDL_FPoint &getVelocity() const { return _velocity; }
+  inline void setVelocity(const SDL_FPoint &velocity) { _velocity = velocity; }
+  inline const SDL_Color &getColor() const { return _color; }
+  inline void setColor(const SDL_Color &color) { _color = color; }
+  inline uint8_t getOpacity() const { return _color.a; }
+  inline void setOpacity(uint8_t opacity) { _color.a = opacity; }
+  inline Fragment::Blend getBlendMode() const { return _blend; }
+  inline void setBlendMode(Fragment::Blend blend) { _blend = blend; }
+  inline int32_t getZIndex() const { return _zIndex; }
+  inline void setZIndex(int32_t zIndex) { _zIndex = zIndex; }
+  inline uint8_t getLayer() const { return _layer; }
+  inline void setLayer(uint8_t layer) { _layer = layer; }
+  void update(uint64_t ticks);
+  void draw(RenderSystem *renderSystem, const SDL_FPoint &camera = {});
+  void release(RenderSystem *renderSystem);
+};
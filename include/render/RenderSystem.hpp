@@ -1,31 +1,145 @@
 #pragma once
 #include "Fragment.hpp"
 #include "core/Object.hpp"
+#include "render/GlyphAtlas.hpp"
+#include "render/Image.hpp"
 #include "runtime/Logger.hpp"
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_render.h>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 class RenderSystem : public Object {
+public:
+  static inline const std::string MISSING_TEXTURE = "system.texture.missing";
+  struct UploadStats {
+    uint64_t uploads = 0;
+    uint64_t bytes = 0;
+    uint32_t pending = 0;
+    uint32_t hitches = 0;
+    float lastTime = 0.f;
+    float maxTime = 0.f;
+  };
+
+private:
+  struct TextureEntry {
+    std::string name;
+    SDL_Texture *texture = nullptr;
+    bool resolved = false;
+    bool queued = false;
+    bool premultiplied = false;
+    SDL_Color color = {255, 255, 255, 255};
+    Fragment::Blend blend = Fragment::Blend::NORMAL;
+  };
+  struct Animation {
+    uint32_t frames = 1;
+    uint32_t period = 0;
+    SDL_FPoint stride = {};
+  };
+  struct DrawItem {
+    uint64_t key;
+    uint32_t fragment;
+  };
+  struct Batch {
+    uint64_t frame = 0;
+    uint32_t id = 0;
+  };
+
 private:
   Logger *_logger = Logger::getLogger("Render");
 
   SDL_Renderer *_renderer = {};
-  std::unordered_map<int32_t, std::vector<Fragment *>> _fragements;
-  std::unordered_map<std::string, SDL_Texture *> _textures;
+  std::vector<Fragment> _fragments;
+  std::vector<DrawItem> _drawList;
+  std::vector<DrawItem> _sortBuffer;
+  // dense per-frame ids of the textures drawn, indexed by handle
+  std::vector<Batch> _batches;
+  uint32_t _batchCount = 0;
+  uint64_t _frame = 1;
+  std::vector<TextureEntry> _textures;
+  std::unordered_map<std::string, uint32_t> _textureHandles;
+  SDL_BlendMode _subtract = SDL_BLENDMODE_INVALID;
+  SDL_BlendMode _subtractPremultiplied = SDL_BLENDMODE_INVALID;
+  SDL_PixelFormat _textureFormat = SDL_PIXELFORMAT_RGBA32;
+  std::unique_ptr<GlyphAtlas> _glyphAtlas = std::make_unique<GlyphAtlas>();
+  std::vector<Animation> _animations;
+  std::vector<SDL_FPoint> _animationOffsets;
+  std::deque<uint32_t> _uploads;
+  size_t _uploadBudget = 8 * 1024 * 1024;
+  float _uploadTime = 2.f;
+  UploadStats _uploadStats;
+
+  SDL_Texture *_scene = nullptr;
+  SDL_Texture *_frozen = nullptr;
+  SDL_Texture *_transitionTarget = nullptr;
+  SDL_Texture *_transitionMask = nullptr;
+  std::string _transitionMaskName;
+  bool _frozenActive = false;
+  bool _transitioning = false;
+  bool _maskSupported = true;
+  uint64_t _transitionStart = 0;
+  uint32_t _transitionDuration = 0;
+  uint32_t _transitionVague = 40;
+
+private:
+  static uint64_t makeSortKey(uint8_t layer, int32_t zIndex, uint32_t batch,
+                              uint32_t sequence);
+  uint32_t getBatch(uint32_t texture);
+  std::shared_ptr<Image> findImage(const std::string &name) const;
+  SDL_Texture *resolveTexture(uint32_t handle);
+  void requestTexture(uint32_t handle);
+  void processUploads();
+  void updateAnimations();
+  SDL_Texture *prepareTexture(const Fragment &fragment);
+  bool prepareScene();
+  SDL_Texture *loadTransitionMask(const std::string &name);
+  bool composeMask(float progress);
+  void composeScreen();
 
 public:
   RenderSystem(SDL_Renderer *renderer);
   ~RenderSystem() override;
-  void draw(Fragment *fragment);
+  void draw(const Fragment &fragment);
+  void draw(const Fragment *fragments, size_t count,
+            const SDL_FPoint &offset = {});
   void present();
-  SDL_Texture *createTexture(const std::string &name, SDL_Surface *surface);
+  void freeze();
+  void transition(uint32_t duration, const std::string &mask = "",
+                  uint32_t vague = 40);
+  inline bool isFrozen() const { return _frozenActive; }
+  inline bool isTransitioning() const { return _transitioning; }
+  bool renderToTexture(uint32_t target, const Fragment *fragments,
+                       size_t count, const SDL_FPoint &offset = {});
+  inline GlyphAtlas *getGlyphAtlas() const { return _glyphAtlas.get(); }
+  inline size_t getUploadBudget() const { return _uploadBudget; }
+  inline void setUploadBudget(size_t bytes) { _uploadBudget = bytes; }
+  inline float getUploadTime() const { return _uploadTime; }
+  inline void setUploadTime(float ms) { _uploadTime = ms; }
+  inline const UploadStats &getUploadStats() const { return _uploadStats; }
+  uint32_t getTextureHandle(const std::string &name);
+  uint16_t createAnimation(uint32_t frames, uint32_t period,
+                           const SDL_FPoint &stride);
+  void setAnimation(uint16_t handle, uint32_t frames, uint32_t period,
+                    const SDL_FPoint &stride);
+  inline SDL_PixelFormat getTextureFormat() const { return _textureFormat; }
+  SDL_Texture *createTexture(const std::string &name, SDL_Surface *surface,
+                             bool premultiplied = false);
   SDL_Texture *
   createTexture(const std::string &name, uint32_t w, uint32_t h,
                 SDL_PixelFormat format = SDL_PIXELFORMAT_RGBA32,
                 SDL_TextureAccess access = SDL_TEXTUREACCESS_STATIC);
+  // Returns the texture once it is uploaded. Until then it is queued for
+  // the per-frame upload budget and nullptr is returned.
   SDL_Texture *getTexture(const std::string &name);
+  SDL_Texture *getTexture(uint32_t handle);
+  inline bool isTextureReady(uint32_t handle) const {
+    return handle < _textures.size() && _textures[handle].resolved;
+  }
+  // Waits for the decode and uploads on the calling thread, outside the
+  // budget. Only for setup code that cannot wait for a later frame.
+  SDL_Texture *loadTexture(const std::string &name);
   void removeTexture(const std::string &name);
-};
\ No newline at end of file
+};
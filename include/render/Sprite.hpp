@@ -35,6 +35,8 @@ public:
   inline void setFlipMode(SDL_FlipMode mode) { _fragment.setFlipMode(mode); }
   inline int32_t getZIndex() const { return _fragment.getZIndex(); }
   inline void setZIndex(int32_t zindex) { _fragment.setZIndex(zindex); }
+  inline uint8_t getLayer() const { return _fragment.getLayer(); }
+  inline void setLayer(uint8_t layer) { _fragment.setLayer(layer); }
   inline void setPosition(const SDL_FPoint &position) {
     _fragment.setPosition(position);
   }
@@ -0,0 +1,55 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/RenderSystem.hpp"
+#include "render/Sprite.hpp"
+#include "runtime/Logger.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+class SpriteAnimator : public Object {
+private:
+  struct Sheet {
+    uint16_t columns;
+    uint16_t rows;
+    float frameWidth;
+    float frameHeight;
+  };
+  struct Clock {
+    uint32_t frames;
+    uint32_t period;
+  };
+
+private:
+  std::vector<Sheet> _sheets;
+  std::vector<Clock> _clocks;
+  std::vector<uint32_t> _clockFrames;
+
+  std::vector<Sprite *> _sprites;
+  std::vector<uint16_t> _spriteSheets;
+  std::vector<uint16_t> _spriteClocks;
+  std::vector<uint16_t> _spriteRows;
+  std::vector<uint16_t> _spritePhases;
+  std::vector<uint32_t> _owners;
+
+  std::vector<uint32_t> _indices;
+  std::vector<uint32_t> _freeIds;
+
+  Logger *_logger = Logger::getLogger("Render");
+
+public:
+  SpriteAnimator();
+  uint16_t createSheet(uint16_t columns, uint16_t rows, float frameWidth,
+                       float frameHeight);
+  uint16_t createSheet(RenderSystem *renderSystem, const std::string &texture,
+                       uint16_t columns, uint16_t rows);
+  uint16_t createClock(uint32_t frames, uint32_t period);
+  void setClock(uint16_t clock, uint32_t frames, uint32_t period);
+  uint32_t add(Sprite *sprite, uint16_t sheet, uint16_t clock = 0);
+  void remove(uint32_t id);
+  void setSheet(uint32_t id, uint16_t sheet);
+  void setClock(uint32_t id, uint16_t clock);
+  void setRow(uint32_t id, uint16_t row);
+  void setPhase(uint32_t id, uint16_t phase);
+  inline size_t getCount() const { return _sprites.size(); }
+  void update(uint64_t ticks);
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/Font.hpp"
+#include "render/Fragment.hpp"
+#include "render/RenderSystem.hpp"
+#include "runtime/Logger.hpp"
+#include <SDL3/SDL_rect.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+class Text : public Object {
+private:
+  std::string _text;
+  std::string _fontName;
+  std::shared_ptr<Font> _font;
+  float _size = 16.f;
+  float _width = 0.f;
+  SDL_FPoint _position = {};
+  SDL_FPoint _bounds = {};
+  SDL_Color _color = {255, 255, 255, 255};
+  int32_t _zIndex = 0;
+  uint8_t _layer = 0;
+  uint32_t _generation = 0;
+  bool _dirty = true;
+  std::vector<Fragment> _fragments;
+
+  Logger *_logger = Logger::getLogger("Render");
+
+private:
+  void layout(RenderSystem *renderSystem, bool retry = true);
+
+public:
+  inline const std::string &getText() const { return _text; }
+  inline void setText(const std::string &text) {
+    if (_text != text) {
+      _text = text;
+      _dirty = true;
+    }
+  }
+  void setI18n(const std::string &key,
+               const std::unordered_map<std::string, std::string> &options =
+                   {});
+  inline const std::string &getFont() const { return _fontName; }
+  inline void setFont(const std::string &font) {
+    if (_fontName != font) {
+      _fontName = font;
+      _font = nullptr;
+      _dirty = true;
+    }
+  }
+  inline float getSize() const { return _size; }
+  inline void setSize(float size) {
+    if (_size != size) {
+      _size = size;
+      _dirty = true;
+    }
+  }
+  inline float getWidth() const { return _width; }
+  inline void setWidth(float width) {
+    if (_width != width) {
+      _width = width;
+      _dirty = true;
+    }
+  }
+  inline const SDL_FPoint &getPosition() const { return _position; }
+  inline void setPosition(const SDL_FPoint &position) { _position = position; }
+  inline const SDL_Color &getColor() const { return _color; }
+  void setColor(const SDL_Color &color);
+  inline int32_t getZIndex() const { return _zIndex; }
+  void setZIndex(int32_t zIndex);
+  inline uint8_t getLayer() const { return _layer; }
+  void setLayer(uint8_t layer);
+  const SDL_FPoint &getBounds(RenderSystem *renderSystem);
+  void draw(RenderSystem *renderSystem);
+};
@@ -0,0 +1,154 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/Autotile.hpp"
+#include "render/Fragment.hpp"
+#include "render/RenderSystem.hpp"
+#include "world/TileWorld.hpp"
+#include <SDL3/SDL_rect.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+class TileLayer : public Object {
+private:
+  struct ChunkCache {
+    uint64_t revision = 0;
+    uint64_t lastUsed = 0;
+    int32_t bake = -1;
+    std::vector<Fragment> fragments;
+  };
+  struct AnimatedTile {
+    uint32_t frames = 1;
+    uint32_t period = 0;
+    uint16_t animation = 0;
+  };
+  struct VariantCache {
+    uint64_t revision = 0;
+    std::vector<uint8_t> variants;
+  };
+
+private:
+  std::shared_ptr<TileWorld> _world = std::make_shared<TileWorld>();
+  std::pair<uint32_t, uint32_t> _size;
+  std::pair<uint32_t, uint32_t> _tileSize;
+  SDL_FRect _viewport = {};
+  std::unordered_map<uint64_t, ChunkCache> _chunks;
+  std::unordered_map<uint64_t, VariantCache> _variants;
+  std::string _texture = RenderSystem::MISSING_TEXTURE;
+  std::shared_ptr<Autotile> _autotile;
+  std::unordered_map<uint32_t, AnimatedTile> _animatedTiles;
+  std::unordered_map<uint32_t, int32_t> _priorities;
+  int32_t _zIndex = 0;
+  uint8_t _layer = 0;
+  bool _static = false;
+  uint32_t _id;
+  std::vector<uint32_t> _bakes;
+  std::vector<uint32_t> _freeBakes;
+  bool _animationDirty = false;
+  uint64_t _frame = 0;
+  bool _dirty = false;
+  // chunks built while the texture was loading used the missing texture
+  bool _textureReady = false;
+
+  Logger *_logger = Logger::getLogger("Render");
+
+private:
+  inline bool isBounded() const { return _size.first && _size.second; }
+  inline bool contains(int32_t x, int32_t y) const {
+    if (!isBounded()) {
+      return true;
+    }
+    return x >= 0 && y >= 0 && static_cast<uint32_t>(x) < _size.first &&
+           static_cast<uint32_t>(y) < _size.second;
+  }
+  static uint64_t makeChunkKey(int32_t cx, int32_t cy);
+  uint8_t computeVariant(int32_t x, int32_t y, uint32_t tile) const;
+  void computeVariants(VariantCache &cache, const TileChunk &chunk, int32_t cx,
+                       int32_t cy);
+  void refreshVariant(int32_t x, int32_t y);
+  void updateAnimations(RenderSystem *renderSystem);
+  void buildChunk(ChunkCache &cache, const TileChunk &chunk, int32_t cx,
+                  int32_t cy, uint32_t texture, const SDL_Texture *atlas);
+  void buildAutotileChunk(ChunkCache &cache, const TileChunk &chunk,
+                          int32_t cx, int32_t cy, uint32_t texture);
+  Fragment &emitTile(ChunkCache &cache, int32_t x, int32_t y, uint32_t tile,
+                     uint32_t texture);
+  void bakeChunk(RenderSystem *renderSystem, ChunkCache &cache, int32_t cx,
+                 int32_t cy);
+  void releaseBake(ChunkCache &cache);
+
+public:
+  TileLayer();
+  inline const std::pair<uint32_t, uint32_t> &getSize() const { return _size; }
+  inline void setSize(const std::pair<uint32_t, uint32_t> &size) {
+    _size = size;
+    _dirty = true;
+  }
+  inline const std::pair<uint32_t, uint32_t> &getTileSize() const {
+    return _tileSize;
+  }
+  inline void setTileSize(const std::pair<uint32_t, uint32_t> &tileSize) {
+    _tileSize = tileSize;
+    _dirty = true;
+    _animationDirty = true;
+  }
+  inline const std::string &getTexture() const { return _texture; }
+  inline void setTexture(const std::string &texture) {
+    _texture = texture;
+    _dirty = true;
+  }
+  inline const std::shared_ptr<Autotile> &getAutotile() const {
+    return _autotile;
+  }
+  inline void setAutotile(const std::shared_ptr<Autotile> &autotile) {
+    _autotile = autotile;
+    _dirty = true;
+  }
+  inline int32_t getZIndex() const { return _zIndex; }
+  inline void setZIndex(int32_t zIndex) {
+    _zIndex = zIndex;
+    _dirty = true;
+  }
+  inline uint8_t getLayer() const { return _layer; }
+  inline void setLayer(uint8_t layer) {
+    _layer = layer;
+    _dirty = true;
+  }
+  inline bool isStatic() const { return _static; }
+  inline void setStatic(bool value) {
+    _static = value;
+    _dirty = true;
+  }
+  inline int32_t getPriority(uint32_t tile) const {
+    auto it = _priorities.find(tile);
+    return it != _priorities.end() ? it->second : 0;
+  }
+  inline void setPriority(uint32_t tile, int32_t priority) {
+    if (priority) {
+      _priorities[tile] = priority;
+    } else {
+      _priorities.erase(tile);
+    }
+    _dirty = true;
+  }
+  inline const SDL_FRect &getViewport() const { return _viewport; }
+  inline void setViewport(const SDL_FRect &viewport) { _viewport = viewport; }
+  inline const std::shared_ptr<TileWorld> &getWorld() const { return _world; }
+  inline void setWorld(const std::shared_ptr<TileWorld> &world) {
+    _world = world;
+    _dirty = true;
+  }
+  inline uint32_t getTile(int32_t x, int32_t y) const {
+    if (!contains(x, y)) {
+      return 0;
+    }
+    return _world->getTile(x, y);
+  }
+  void setTile(int32_t x, int32_t y, uint32_t tile);
+  void setAnimatedTile(uint32_t tile, uint32_t frames, uint32_t period);
+  void removeAnimatedTile(uint32_t tile);
+  void draw(RenderSystem *renderSystem);
+  void release(RenderSystem *renderSystem);
+};
@@ -1,54 +1,46 @@
 #pragma once
 #include "core/Object.hpp"
-#include "render/Fragment.hpp"
 #include "render/RenderSystem.hpp"
+#include "render/TileLayer.hpp"
+#include <SDL3/SDL_rect.h>
+#include <cstddef>
 #include <cstdint>
-#include <string>
-#include <unordered_map>
+#include <memory>
 #include <utility>
 #include <vector>
 class TileMap : public Object {
 private:
+  std::vector<std::shared_ptr<TileLayer>> _layers;
   std::pair<uint32_t, uint32_t> _size;
   std::pair<uint32_t, uint32_t> _tileSize;
-  std::vector<uint32_t> _tiles;
-  std::unordered_map<size_t, Fragment> _fragements;
-  std::string _texture = "system.texture.missing";
-  bool _dirty = false;
+  SDL_FRect _viewport = {};
 
 public:
   inline const std::pair<uint32_t, uint32_t> &getSize() const { return _size; }
-  inline void setSize(const std::pair<uint32_t, uint32_t> &size) {
-    _size = size;
-    _tiles.resize(_size.first * _size.second, 0);
-    _fragements.clear();
-    _dirty = true;
-  }
+  void setSize(const std::pair<uint32_t, uint32_t> &size);
   inline const std::pair<uint32_t, uint32_t> &getTileSize() const {
     return _tileSize;
   }
-  inline void setTileSize(const std::pair<uint32_t, uint32_t> &tileSize) {
-    _tileSize = tileSize;
-    _dirty = true;
-  }
-  inline const std::string &getTexture() const { return _texture; }
-  inline void setTexture(const std::string &texture) {
-    _texture = texture;
-    _dirty = true;
+  void setTileSize(const std::pair<uint32_t, uint32_t> &tileSize);
+  inline const SDL_FRect &getViewport() const { return _viewport; }
+  void setViewport(const SDL_FRect &viewport);
+  inline size_t getLayerCount() const { return _layers.size(); }
+  inline const std::shared_ptr<TileLayer> &getLayer(size_t index) const {
+    return _layers[index];
   }
-  inline uint32_t getTile(uint32_t x, uint32_t y) const {
-    if (x >= _size.first || y >= _size.second) {
+  std::shared_ptr<TileLayer> addLayer();
+  void removeLayer(RenderSystem *renderSystem, size_t index);
+  inline uint32_t getTile(size_t layer, int32_t x, int32_t y) const {
+    if (layer >= _layers.size()) {
       return 0;
     }
-    return _tiles[y * _size.first + x];
+    return _layers[layer]->getTile(x, y);
   }
-  inline void setTile(uint32_t x, uint32_t y, uint32_t tile) {
-    if (x >= _size.first || y >= _size.second) {
-      return;
+  inline void setTile(size_t layer, int32_t x, int32_t y, uint32_t tile) {
+    if (layer < _layers.size()) {
+      _layers[layer]->setTile(x, y, tile);
     }
-    auto idx = y * _size.first + x;
-    _tiles[idx] = tile;
-    _dirty = true;
   }
   void draw(RenderSystem *renderSystem);
-};
\ No newline at end of file
+  void release(RenderSystem *renderSystem);
+};
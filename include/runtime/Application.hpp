@@ -7,6 +7,7 @@
 #include "render/RenderSystem.hpp"
 #include "runtime/Logger.hpp"
 #include "runtime/ModManager.hpp"
+#include "ui/UIManager.hpp"
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_events.h>
 #include <memory>
@@ -34,6 +35,7 @@ private:
   std::unique_ptr<ConfigManager> _configManager;
   std::unique_ptr<SaveManager> _saveManager;
   std::unique_ptr<ModManager> _modManager;
+  std::unique_ptr<UIManager> _uiManager;
 
 private:
   void resolveOptions(int argc, char **argv);
@@ -45,6 +47,7 @@ private:
   bool initSaveManager();
   bool initModManager();
   bool initLocaleManager();
+  bool initUIManager();
   void cleanup();
   bool processEvent();
 
@@ -81,6 +84,7 @@ public:
   inline LocaleManager *getLocaleManager() const {
     return _localeManager.get();
   }
+  inline UIManager *getUIManager() const { return _uiManager.get(); }
 
 public:
   static Application *getInstance() {
@@ -2,22 +2,138 @@
 #include "core/Object.hpp"
 #include "core/Variable.hpp"
 #include "runtime/Logger.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
+// Configs are read and changed on the main thread. Saves are coalesced and
+// written by a background thread, which replaces each file atomically.
 class ConfigManager : public Object {
+public:
+  // saves of the same file within this window are written once
+  static constexpr uint32_t SAVE_DELAY = 500;
+  // Called with the dotted key that changed, or an empty key and the whole
+  // config after saveConfig().
+  using Listener =
+      std::function<void(const std::string &key, const Variable &value)>;
+
+private:
+  struct Binding {
+    std::string ns;
+    std::string name;
+    std::string key;
+    virtual ~Binding() = default;
+    virtual void update(const Variable *value) = 0;
+  };
+  template <class T> struct TypedBinding : public Binding {
+    T value;
+    T fallback;
+    void update(const Variable *value) override {
+      if (!value) {
+        this->value = fallback;
+      } else if constexpr (std::is_same_v<T, Variable>) {
+        this->value = *value;
+      } else if constexpr (std::is_same_v<T, bool>) {
+        this->value = value->getBoolean(fallback);
+      } else if constexpr (std::is_arithmetic_v<T>) {
+        this->value = static_cast<T>(value->getNumber(fallback));
+      } else {
+        this->value = value->getString(fallback);
+      }
+    }
+  };
+
+public:
+  // Cached copy of one config entry, refreshed by setValue() and
+  // saveConfig(), so hot paths read it without any lookup.
+  template <class T> class Value {
+  private:
+    std::shared_ptr<TypedBinding<T>> _binding;
+
+  public:
+    Value() = default;
+    Value(std::shared_ptr<TypedBinding<T>> binding)
+        : _binding(std::move(binding)) {}
+    inline const T &get() const { return _binding->value; }
+    inline operator const T &() const { return _binding->value; }
+  };
+
+private:
+  struct Subscription {
+    uint64_t id;
+    std::string ns;
+    std::string name;
+    Listener listener;
+  };
+  struct Pending {
+    Variable config;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
 private:
   std::string _configPath;
   std::unordered_map<std::string, std::unordered_map<std::string, Variable>>
       _configs;
+  std::vector<std::weak_ptr<Binding>> _bindings;
+  std::vector<Subscription> _subscriptions;
+  uint64_t _nextSubscription = 1;
+  // keyed by file path, written by _writer once the deadline passes
+  std::unordered_map<std::string, Pending> _pending;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _idle;
+  bool _stopping = false;
+  bool _writing = false;
+  std::thread _writer;
   Logger *_logger = Logger::getLogger("ConfigManager");
 
 private:
   void loadConfig(const std::string &ns, const std::string &name);
   std::string writeToml(const Variable &variable);
+  bool writeFile(const std::string &path, const Variable &config);
+  void run();
+  void schedule(const std::string &ns, const std::string &name);
+  void notify(const std::string &ns, const std::string &name,
+              const std::string &key, const Variable &value);
+  void addBinding(const std::shared_ptr<Binding> &binding);
+  static Variable *findValue(Variable &config, const std::string &key,
+                             bool create);
 
 public:
   ConfigManager();
+  ~ConfigManager() override;
   bool hasConfig(const std::string &ns, const std::string &name);
   Variable &getConfig(const std::string &ns, const std::string &name);
+  // Queues the config to be written in the background. Also refreshes
+  // bindings and notifies subscribers, since callers may have edited it
+  // through getConfig().
   void saveConfig(const std::string &ns, const std::string &name);
-};
\ No newline at end of file
+  // Writes every queued config now.
+  void flush();
+  // `key` is a dotted path into the config's tables, e.g. "video.width".
+  const Variable *getValue(const std::string &ns, const std::string &name,
+                           const std::string &key);
+  void setValue(const std::string &ns, const std::string &name,
+                const std::string &key, const Variable &value);
+  template <class T>
+  Value<T> bindValue(const std::string &ns, const std::string &name,
+                     const std::string &key, const T &fallback = {}) {
+    auto binding = std::make_shared<TypedBinding<T>>();
+    binding->ns = ns;
+    binding->name = name;
+    binding->key = key;
+    binding->fallback = fallback;
+    addBinding(binding);
+    return binding;
+  }
+  uint64_t subscribe(const std::string &ns, const std::string &name,
+                     Listener listener);
+  void unsubscribe(uint64_t id);
+};
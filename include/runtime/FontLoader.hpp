@@ -0,0 +1,9 @@
+#pragma once
+#include "runtime/AssetLoader.hpp"
+#include "runtime/Logger.hpp"
+class FontLoader : public AssetLoader {
+private:
+  Logger *_logger = Logger::getLogger("FontLoader");
+public:
+  std::shared_ptr<Object> load(const std::string &path) override;
+};
@@ -1,9 +1,26 @@
 #pragma once
+#include "core/ThreadPool.hpp"
 #include "runtime/AssetLoader.hpp"
 #include "runtime/Logger.hpp"
+#include <SDL3/SDL.h>
+#include <memory>
 class ImageLoader : public AssetLoader {
 private:
+  std::unique_ptr<ThreadPool> _decoder = std::make_unique<ThreadPool>();
+  SDL_PixelFormat _format = SDL_PIXELFORMAT_RGBA32;
+  bool _premultiplied = false;
   Logger *_logger = Logger::getLogger("ImageLoader");
+
+private:
+  static SDL_Surface *normalize(SDL_Surface *surface, SDL_PixelFormat format,
+                                bool premultiplied);
+
 public:
+  inline SDL_PixelFormat getFormat() const { return _format; }
+  inline void setFormat(SDL_PixelFormat format) { _format = format; }
+  inline bool isPremultiplied() const { return _premultiplied; }
+  inline void setPremultiplied(bool premultiplied) {
+    _premultiplied = premultiplied;
+  }
   std::shared_ptr<Object> load(const std::string &path) override;
-};
\ No newline at end of file
+};
@@ -37,6 +37,7 @@ public:
   std::string
   i18n(const std::string &key,
        const std::unordered_map<std::string, std::string> &options = {}) const;
+  void addLocales(const std::string &source, const std::string &name);
   void addLanguage(const std::string &key, const Locale &locale);
   void removeLanguage(const std::string &key);
   bool hasLanguage(const std::string &key) const;
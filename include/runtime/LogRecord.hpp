@@ -0,0 +1,122 @@
+#pragma once
+#include "core/Object.hpp"
+#include <cstddef>
+#include <format>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+// Arguments a record may keep until the writer formats it: values and
+// owned copies of strings. Anything else is formatted on the caller.
+template <class T> struct LogArgument {
+  using type = void;
+};
+template <class T>
+  requires std::is_arithmetic_v<T>
+struct LogArgument<T> {
+  using type = T;
+};
+template <> struct LogArgument<const char *> {
+  using type = std::string;
+};
+template <> struct LogArgument<char *> {
+  using type = std::string;
+};
+template <> struct LogArgument<std::string> {
+  using type = std::string;
+};
+template <> struct LogArgument<std::string_view> {
+  using type = std::string;
+};
+
+class LogRecord : public Object {
+public:
+  static constexpr size_t CAPACITY = 160;
+
+private:
+  struct Ops {
+    void (*format)(std::string &output, std::string_view fmt,
+                   const void *args);
+    void (*move)(void *dst, void *src);
+    void (*destroy)(void *args);
+  };
+
+private:
+  const Ops *_ops = nullptr;
+  std::string_view _format;
+  alignas(std::max_align_t) std::byte _storage[CAPACITY];
+
+private:
+  template <class Tuple> static const Ops *getOps() {
+    static constexpr Ops ops = {
+        [](std::string &output, std::string_view fmt, const void *args) {
+          std::apply(
+              [&](const auto &...values) {
+                std::vformat_to(std::back_inserter(output), fmt,
+                                std::make_format_args(values...));
+              },
+              *static_cast<const Tuple *>(args));
+        },
+        [](void *dst, void *src) {
+          new (dst) Tuple(std::move(*static_cast<Tuple *>(src)));
+        },
+        [](void *args) { static_cast<Tuple *>(args)->~Tuple(); }};
+    return &ops;
+  }
+  template <class Tuple, class... Args>
+  void emplace(std::string_view fmt, Args &&...args) {
+    reset();
+    new (_storage) Tuple(std::forward<Args>(args)...);
+    _ops = getOps<Tuple>();
+    _format = fmt;
+  }
+
+public:
+  LogRecord() = default;
+  LogRecord(LogRecord &&other) noexcept { *this = std::move(other); }
+  LogRecord &operator=(LogRecord &&other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other._ops) {
+        other._ops->move(_storage, other._storage);
+        _ops = other._ops;
+        _format = other._format;
+        other.reset();
+      }
+    }
+    return *this;
+  }
+  ~LogRecord() override { reset(); }
+  inline void reset() {
+    if (_ops) {
+      _ops->destroy(_storage);
+      _ops = nullptr;
+    }
+  }
+  inline void setMessage(std::string &&message) {
+    emplace<std::tuple<std::string>>("{}", std::move(message));
+  }
+  // `fmt` must outlive the record, which holds for the literals behind
+  // std::format_string
+  template <class... Args> void store(std::string_view fmt, Args &&...args) {
+    if constexpr ((!std::is_void_v<
+                       typename LogArgument<std::decay_t<Args>>::type> &&
+                   ...)) {
+      using Tuple =
+          std::tuple<typename LogArgument<std::decay_t<Args>>::type...>;
+      if constexpr (sizeof(Tuple) <= CAPACITY &&
+                    alignof(Tuple) <= alignof(std::max_align_t)) {
+        emplace<Tuple>(fmt, std::forward<Args>(args)...);
+        return;
+      }
+    }
+    setMessage(std::vformat(fmt, std::make_format_args(args...)));
+  }
+  inline void format(std::string &output) const {
+    if (_ops) {
+      _ops->format(output, _format, _storage);
+    }
+  }
+};
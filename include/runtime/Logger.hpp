@@ -1,64 +1,101 @@
 #pragma once
 #include "core/Object.hpp"
+#include "runtime/LogRecord.hpp"
 #include <SDL3/SDL_log.h>
+#include <atomic>
+#include <cstdio>
 #include <cstdint>
 #include <format>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+// Priorities below this one are compiled out of every Logger call, e.g.
+// -DLOGGER_MIN_PRIORITY=SDL_LOG_PRIORITY_INFO for release builds.
+#ifndef LOGGER_MIN_PRIORITY
+#define LOGGER_MIN_PRIORITY SDL_LOG_PRIORITY_TRACE
+#endif
 
 class Logger : public Object {
+private:
+  class Backend;
+
 private:
   static uint32_t _maxCategory;
   static std::unordered_map<int, std::string> _categoryNames;
   static std::unordered_map<std::string, std::unique_ptr<Logger>> _loggers;
+  static std::unordered_map<std::string, SDL_LogPriority> _overrides;
+  static std::mutex _mutex;
+  static SDL_LogPriority _defaultPriority;
+
+private:
+  static Backend &getBackend();
+  static void submit(const std::string *category, SDL_LogPriority priority,
+                     LogRecord &&record);
+  static SDL_LogPriority parsePriority(const std::string &name);
 
 public:
   static void print(void *userdata, int category, SDL_LogPriority priority,
                     const char *message);
   static void setPriorities(const std::string &priorities);
+  static void flush();
+  static void shutdown();
+  static void setOutput(FILE *output);
 
 private:
   uint32_t _category = 0;
-  Logger(uint32_t category);
+  const std::string *_name = nullptr;
+  std::atomic<int> _priority = SDL_LOG_PRIORITY_INFO;
+  Logger(uint32_t category, const std::string *name);
+
+  template <SDL_LogPriority Priority, class... Args>
+  void log(std::format_string<Args...> fmt, Args &&...args) {
+    if constexpr (Priority >= LOGGER_MIN_PRIORITY) {
+      if (isEnabled(Priority)) {
+        LogRecord record;
+        record.store(fmt.get(), std::forward<Args>(args)...);
+        submit(_name, Priority, std::move(record));
+      }
+    }
+  }
+
+public:
+  inline bool isEnabled(SDL_LogPriority priority) const {
+    return priority >= _priority.load(std::memory_order_relaxed);
+  }
+  void setPriority(SDL_LogPriority priority);
 
 public:
   template <class... Args>
   void trace(std::format_string<Args...> fmt, Args &&...args) {
-    SDL_LogTrace(_category, "%s",
-                 std::format(fmt, std::forward<Args>(args)...).c_str());
+    log<SDL_LOG_PRIORITY_TRACE>(fmt, std::forward<Args>(args)...);
   }
   template <class... Args>
   void debug(std::format_string<Args...> fmt, Args &&...args) {
-    SDL_LogDebug(_category, "%s",
-                 std::format(fmt, std::forward<Args>(args)...).c_str());
+    log<SDL_LOG_PRIORITY_DEBUG>(fmt, std::forward<Args>(args)...);
   }
   template <class... Args>
   void verbos(std::format_string<Args...> fmt, Args &&...args) {
-    SDL_LogVerbose(_category, "%s",
-                   std::format(fmt, std::forward<Args>(args)...).c_str());
+    log<SDL_LOG_PRIORITY_VERBOSE>(fmt, std::forward<Args>(args)...);
   }
   template <class... Args>
   void info(std::format_string<Args...> fmt, Args &&...args) {
-    SDL_LogInfo(_category, "%s",
-                std::format(fmt, std::forward<Args>(args)...).c_str());
+    log<SDL_LOG_PRIORITY_INFO>(fmt, std::forward<Args>(args)...);
   }
   template <class... Args>
   void warn(std::format_string<Args...> fmt, Args &&...args) {
-    SDL_LogWarn(_category, "%s",
-                std::format(fmt, std::forward<Args>(args)...).c_str());
+    log<SDL_LOG_PRIORITY_WARN>(fmt, std::forward<Args>(args)...);
   }
   template <class... Args>
   void error(std::format_string<Args...> fmt, Args &&...args) {
-    SDL_LogError(_category, "%s",
-                 std::format(fmt, std::forward<Args>(args)...).c_str());
+    log<SDL_LOG_PRIORITY_ERROR>(fmt, std::forward<Args>(args)...);
   }
   template <class... Args>
   void critial(std::format_string<Args...> fmt, Args &&...args) {
-    SDL_LogCritical(_category, "%s",
-                    std::format(fmt, std::forward<Args>(args)...).c_str());
+    log<SDL_LOG_PRIORITY_CRITICAL>(fmt, std::forward<Args>(args)...);
+    flush();
   }
 
 public:
   static Logger *getLogger(const std::string &category);
-};
\ No newline at end of file
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include "core/Object.hpp"
+#include "core/Variable.hpp"
+#include <SDL3/SDL_iostream.h>
+#include <cstdint>
+#include <vector>
+// Layout shared by SaveWriter and SaveReader:
+//   header   magic, version, index offset, index size, flags, base, generation
+//   sections one zstd frame each, in any order
+//   index    one fixed-size Entry per section
+// Sections are addressed by (type, layer, x, y) through the index, so readers
+// can fetch any of them without scanning the file.
+//
+// A delta file (FLAG_DELTA) holds only the chunks changed since the previous
+// generation of the same base, plus complete metadata, map and entities.
+// Readers apply deltas 1, 2, ... on top of the base; later sections win.
+class SaveFile : public Object {
+public:
+  static constexpr uint32_t MAGIC = 0x56534954; // "TISV"
+  static constexpr uint32_t VERSION = 2;
+  static constexpr uint32_t FLAG_DELTA = 1;
+  static constexpr uint32_t ENTRY_SIZE = 32;
+  static constexpr uint8_t CODEC_ZSTD = 1;
+
+  enum class Section : uint8_t {
+    // Variable supplied by the game.
+    METADATA = 1,
+    // Variable describing the tile map: size, tile size, layer count.
+    MAP = 2,
+    // One TileChunk of layer `layer` at chunk coordinates (x, y).
+    CHUNK = 3,
+    // Count followed by Variables; x numbers the batch.
+    ENTITIES = 4,
+  };
+
+  struct Header {
+    uint32_t version = VERSION;
+    uint64_t indexOffset = 0;
+    uint32_t indexSize = 0;
+    uint32_t flags = 0;
+    // identifies the base save a delta applies to; version 2 and later
+    uint32_t base = 0;
+    uint32_t generation = 0;
+  };
+
+  struct Entry {
+    Section type = Section::METADATA;
+    uint8_t codec = CODEC_ZSTD;
+    uint16_t layer = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+    uint32_t size = 0;
+    uint32_t rawSize = 0;
+    uint64_t offset = 0;
+  };
+
+public:
+  static inline uint32_t getHeaderSize(uint32_t version) {
+    return version >= 2 ? 32 : 24;
+  }
+  static bool writeHeader(SDL_IOStream *io, const Header &header);
+  static bool readHeader(SDL_IOStream *io, Header &header);
+  static bool writeIndex(SDL_IOStream *io, const std::vector<Entry> &index);
+  static bool readIndex(SDL_IOStream *io, const Header &header,
+                        std::vector<Entry> &index);
+  static bool writeVariable(SDL_IOStream *io, const Variable &value);
+  static bool readVariable(SDL_IOStream *io, Variable &value,
+                           uint32_t depth = 0);
+};
@@ -1,12 +1,106 @@
 #pragma once
 #include "core/Object.hpp"
+#include "core/Variable.hpp"
+#include "render/TileMap.hpp"
 #include "runtime/Logger.hpp"
+#include "core/ThreadPool.hpp"
+#include "runtime/SaveReader.hpp"
+#include "runtime/SaveWriter.hpp"
+#include "world/TileWorld.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
+// Saves after the first one in a session are written as deltas holding only
+// the chunks edited since the previous save, next to the base file. After
+// too many deltas, or once they add up to a large part of the base, the next
+// save is a full one and the deltas are removed.
 class SaveManager : public Object {
+public:
+  static constexpr uint32_t MAX_DELTAS = 16;
+  static constexpr double COMPACT_RATIO = 0.5;
+
+  struct AutosaveStats {
+    uint32_t count = 0;
+    // autosaves written as deltas rather than full saves
+    uint32_t deltas = 0;
+    uint32_t skipped = 0;
+    uint32_t failed = 0;
+    // main thread time spent snapshotting the last autosave
+    double snapshotTime = 0;
+    double maxSnapshotTime = 0;
+    // background time spent encoding, writing and syncing it
+    double writeTime = 0;
+    size_t fileBytes = 0;
+  };
+
 private:
   std::string _savePath;
+  std::unique_ptr<ThreadPool> _autosaver;
+  std::atomic<bool> _autosaving = false;
+  mutable std::mutex _mutex;
+  AutosaveStats _autosaveStats;
+  struct SaveState {
+    uint32_t base = 0;
+    uint32_t generation = 0;
+    size_t baseBytes = 0;
+    size_t deltaBytes = 0;
+  };
+  std::unordered_map<std::string, SaveState> _states;
+  // save the worlds' change tracking is relative to; deltas are only valid
+  // against it
+  std::string _tracked;
+  // the last load and the worlds it streams into; until it is complete some
+  // chunks only exist in the save files, so a full save must wait for it
+  std::shared_ptr<SaveReader> _reader;
+  std::vector<std::shared_ptr<TileWorld>> _loading;
+  uint32_t _maxDeltas = MAX_DELTAS;
+  double _compactRatio = COMPACT_RATIO;
   Logger *_logger = Logger::getLogger("SaveManager");
 
+private:
+  std::unique_ptr<SaveWriter> prepare(const std::string &name, TileMap &map,
+                                      const Variable &metadata,
+                                      std::vector<Variable> entities);
+  void finish(const std::string &name, const SaveWriter &writer, bool ok);
+  void removeDeltas(const std::string &name);
+  bool finishLoad();
+
 public:
   SaveManager();
-};
\ No newline at end of file
+  ~SaveManager() override;
+  inline const std::string &getSavePath() const { return _savePath; }
+  inline std::string getSaveFile(const std::string &name) const {
+    return _savePath + name + "/world.sav";
+  }
+  inline std::string getDeltaFile(const std::string &name,
+                                  uint32_t generation) const {
+    return _savePath + name + "/world." + std::to_string(generation) +
+           ".delta";
+  }
+  inline uint32_t getMaxDeltas() const { return _maxDeltas; }
+  inline void setMaxDeltas(uint32_t deltas) { _maxDeltas = deltas; }
+  inline double getCompactRatio() const { return _compactRatio; }
+  inline void setCompactRatio(double ratio) { _compactRatio = ratio; }
+  std::shared_ptr<TileWorld> openWorld(const std::string &name);
+  bool save(const std::string &name, TileMap &map, const Variable &metadata,
+            std::vector<Variable> entities = {});
+  // Snapshots the map on the calling thread and writes the save in the
+  // background. Skipped while the previous autosave is still writing.
+  bool autosave(const std::string &name, TileMap &map,
+                const Variable &metadata, std::vector<Variable> entities = {});
+  inline bool isAutosaving() const { return _autosaving.load(); }
+  void waitAutosave();
+  AutosaveStats getAutosaveStats() const;
+  // Restores the map layout, metadata and entities right away and returns
+  // the reader to stream chunks into the map's worlds with poll(). Deltas are
+  // applied on top of the base. Every world of the map is reset first, so
+  // nothing from before the load survives; chunks edited while streaming
+  // are kept. Saving before the reader is complete installs the rest first.
+  std::shared_ptr<SaveReader> load(const std::string &name, TileMap &map,
+                                   Variable &metadata,
+                                   std::vector<Variable> &entities);
+  static std::vector<std::shared_ptr<TileWorld>> getWorlds(const TileMap &map);
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include "core/Buffer.hpp"
+#include "core/Object.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Variable.hpp"
+#include "runtime/Logger.hpp"
+#include "runtime/SaveFile.hpp"
+#include "world/TileWorld.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+// Opens a save by its index and streams chunks in on a thread pool, nearest
+// to the focus first. Metadata, map and entities are small and read on
+// demand; chunks are handed to the worlds through poll() a few per frame.
+// Deltas opened along with the base are merged into one index up front, so
+// each chunk is only read from the newest file that has it.
+class SaveReader : public Object {
+public:
+  static constexpr size_t MAX_IN_FLIGHT = 64;
+
+private:
+  struct Loaded {
+    uint16_t layer;
+    int32_t cx;
+    int32_t cy;
+    TileChunk chunk;
+  };
+
+private:
+  std::string _path;
+  std::vector<SDL_IOStream *> _files;
+  SaveFile::Header _header;
+  uint32_t _generation = 0;
+  // chunks edited after this revision are not overwritten by poll()
+  uint64_t _revision = 0;
+  std::vector<SaveFile::Entry> _index;
+  // file each entry of the index is read from
+  std::vector<size_t> _sources;
+  std::vector<size_t> _pending;
+  int32_t _focusX = 0;
+  int32_t _focusY = 0;
+  bool _sorted = false;
+  size_t _chunkCount = 0;
+  size_t _inFlight = 0;
+  size_t _installed = 0;
+  size_t _failed = 0;
+  std::mutex _fileMutex;
+  std::mutex _mutex;
+  std::vector<Loaded> _loaded;
+  std::unique_ptr<ThreadPool> _decoder;
+
+  Logger *_logger = Logger::getLogger("SaveManager");
+
+private:
+  size_t findSection(SaveFile::Section type, int32_t x = 0) const;
+  bool readSection(size_t index, Buffer &data);
+  bool readVariable(SaveFile::Section type, Variable &value);
+  void request(size_t index);
+
+public:
+  ~SaveReader() override;
+  bool open(const std::string &path);
+  // Opens a base save followed by its deltas in generation order. Deltas
+  // that do not continue the chain are ignored along with everything after.
+  bool open(const std::vector<std::string> &paths);
+  void close();
+  inline const std::string &getPath() const { return _path; }
+  inline uint32_t getVersion() const { return _header.version; }
+  inline uint32_t getBase() const { return _header.base; }
+  // generation of the newest delta applied, 0 for none
+  inline uint32_t getGeneration() const { return _generation; }
+  inline size_t getFileCount() const { return _files.size(); }
+  inline size_t getChunkCount() const { return _chunkCount; }
+  inline size_t getLoadedCount() const { return _installed + _failed; }
+  inline bool isComplete() const { return getLoadedCount() == _chunkCount; }
+  inline bool readMetadata(Variable &metadata) {
+    return readVariable(SaveFile::Section::METADATA, metadata);
+  }
+  inline bool readMap(Variable &map) {
+    return readVariable(SaveFile::Section::MAP, map);
+  }
+  bool readEntities(std::vector<Variable> &entities);
+  // Chunk coordinates to load outwards from; may move while loading.
+  void setFocus(int32_t cx, int32_t cy);
+  // Installs up to `budget` decoded chunks into `worlds`, indexed by layer,
+  // and keeps the decoder busy. Returns the number installed.
+  size_t poll(const std::vector<std::shared_ptr<TileWorld>> &worlds,
+              size_t budget = SIZE_MAX);
+  // Blocks until every chunk is installed.
+  void finish(const std::vector<std::shared_ptr<TileWorld>> &worlds);
+};
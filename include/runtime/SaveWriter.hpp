@@ -0,0 +1,82 @@
+#pragma once
+#include "core/Buffer.hpp"
+#include "core/Compression.hpp"
+#include "core/Object.hpp"
+#include "core/Variable.hpp"
+#include "runtime/Logger.hpp"
+#include "runtime/SaveFile.hpp"
+#include "world/TileWorld.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+// Collects the pieces of a save, then encodes and compresses every section
+// on a thread pool while the calling thread writes finished sections to disk.
+// The file is written next to `path`, synced and renamed into place, so a
+// crash leaves either the old save or the new one. Everything commit() needs
+// is captured up front, so it may run on another thread.
+class SaveWriter : public Object {
+public:
+  static constexpr size_t ENTITY_BATCH = 1024;
+
+  struct Stats {
+    size_t sections = 0;
+    size_t rawBytes = 0;
+    size_t fileBytes = 0;
+    double seconds = 0;
+  };
+
+private:
+  struct Job {
+    SaveFile::Entry entry;
+    const Variable *variable = nullptr;
+    const TileChunk *chunk = nullptr;
+    size_t first = 0;
+    size_t count = 0;
+  };
+  struct Layer {
+    uint16_t layer;
+    TileWorld::Snapshot snapshot;
+  };
+
+private:
+  std::string _path;
+  int _level = Compression::DEFAULT_LEVEL;
+  size_t _threads = 0;
+  uint32_t _base = 0;
+  uint32_t _generation = 0;
+  Variable _metadata;
+  Variable _map;
+  std::vector<Layer> _layers;
+  std::vector<Variable> _entities;
+  Stats _stats;
+
+  Logger *_logger = Logger::getLogger("SaveManager");
+
+private:
+  bool encode(const Job &job, Buffer &output, uint32_t &rawSize) const;
+
+public:
+  SaveWriter(const std::string &path);
+  inline const std::string &getPath() const { return _path; }
+  inline void setLevel(int level) { _level = level; }
+  inline void setThreadCount(size_t threads) { _threads = threads; }
+  inline const Stats &getStats() const { return _stats; }
+  inline uint32_t getBase() const { return _base; }
+  inline uint32_t getGeneration() const { return _generation; }
+  // Generation 0 writes a full save; later generations write deltas that
+  // apply on top of the save tagged with `base`.
+  inline void setGeneration(uint32_t base, uint32_t generation) {
+    _base = base;
+    _generation = generation;
+  }
+  inline void setMetadata(const Variable &metadata) { _metadata = metadata; }
+  inline void setMap(const Variable &map) { _map = map; }
+  // Takes a copy-on-write snapshot; later edits to `world` are not saved.
+  // With `changes`, only chunks edited since the world's last snapshot.
+  void addLayer(uint16_t layer, TileWorld &world, bool changes = false);
+  inline void setEntities(std::vector<Variable> entities) {
+    _entities = std::move(entities);
+  }
+  bool commit();
+};
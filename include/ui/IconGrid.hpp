@@ -0,0 +1,58 @@
+#pragma once
+#include "render/Text.hpp"
+#include "ui/Window.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+class IconGrid : public Window {
+public:
+  struct Slot {
+    std::string icon;
+    uint32_t count = 0;
+  };
+
+private:
+  std::vector<Slot> _slots;
+  std::vector<std::unique_ptr<Text>> _counts;
+  std::string _font;
+  float _fontSize = 14.f;
+  uint32_t _columns = 10;
+  float _slotSize = 32.f;
+  int32_t _selected = -1;
+  // icons laid out before their size was known
+  std::vector<uint32_t> _loading;
+
+private:
+  void updateCursor();
+
+protected:
+  void build(RenderSystem *renderSystem,
+             std::vector<Fragment> &fragments) override;
+  void drawContents(RenderSystem *renderSystem,
+                    const SDL_FPoint &origin) override;
+
+public:
+  inline size_t getSlotCount() const { return _slots.size(); }
+  void setSlotCount(size_t count);
+  inline const Slot &getSlot(size_t index) const { return _slots[index]; }
+  void setSlot(size_t index, const Slot &slot);
+  inline uint32_t getColumns() const { return _columns; }
+  inline void setColumns(uint32_t columns) {
+    _columns = std::max(columns, 1u);
+    markDirty();
+    updateCursor();
+  }
+  inline float getSlotSize() const { return _slotSize; }
+  inline void setSlotSize(float size) {
+    _slotSize = size;
+    markDirty();
+    updateCursor();
+  }
+  void setFont(const std::string &font, float size);
+  inline int32_t getSelected() const { return _selected; }
+  void setSelected(int32_t index);
+  bool onMouseButtonDown(const SDL_MouseButtonEvent &event,
+                         const SDL_FPoint &point) override;
+  bool onKeyDown(const SDL_KeyboardEvent &event) override;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include "render/Text.hpp"
+#include "ui/Window.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+class ListView : public Window {
+private:
+  std::vector<std::unique_ptr<Text>> _items;
+  std::string _font;
+  float _fontSize = 22.f;
+  float _itemHeight = 32.f;
+  int32_t _selected = -1;
+  uint32_t _top = 0;
+
+private:
+  uint32_t getVisibleCount() const;
+  void updateCursor();
+
+protected:
+  void drawContents(RenderSystem *renderSystem,
+                    const SDL_FPoint &origin) override;
+
+public:
+  inline size_t getItemCount() const { return _items.size(); }
+  void setItems(const std::vector<std::string> &items);
+  void setItem(size_t index, const std::string &item);
+  inline const std::string &getFont() const { return _font; }
+  void setFont(const std::string &font, float size);
+  inline float getItemHeight() const { return _itemHeight; }
+  inline void setItemHeight(float height) {
+    _itemHeight = height;
+    updateCursor();
+  }
+  inline int32_t getSelected() const { return _selected; }
+  void setSelected(int32_t index);
+  bool onMouseButtonDown(const SDL_MouseButtonEvent &event,
+                         const SDL_FPoint &point) override;
+  bool onKeyDown(const SDL_KeyboardEvent &event) override;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/RenderSystem.hpp"
+#include "runtime/Logger.hpp"
+#include "ui/Widget.hpp"
+#include <SDL3/SDL_events.h>
+#include <cstdint>
+#include <memory>
+class UIManager : public Object {
+public:
+  static constexpr uint8_t LAYER = 200;
+
+private:
+  std::shared_ptr<Widget> _root = std::make_shared<Widget>();
+  Widget *_focus = nullptr;
+  uint8_t _layer = LAYER;
+
+  Logger *_logger = Logger::getLogger("UIManager");
+
+public:
+  inline const std::shared_ptr<Widget> &getRoot() const { return _root; }
+  inline Widget *getFocus() const { return _focus; }
+  inline void setFocus(Widget *widget) { _focus = widget; }
+  inline uint8_t getLayer() const { return _layer; }
+  inline void setLayer(uint8_t layer) { _layer = layer; }
+  void resize(float width, float height);
+  bool onMouseButtonDown(const SDL_MouseButtonEvent &event);
+  bool onKeyDown(const SDL_KeyboardEvent &event);
+  void update(uint64_t ticks);
+  void draw(RenderSystem *renderSystem);
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include "core/Object.hpp"
+#include "render/Fragment.hpp"
+#include "render/RenderSystem.hpp"
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_events.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+class Widget : public Object {
+public:
+  static constexpr int32_t DEPTH_STEP = 4;
+
+protected:
+  SDL_FRect _rect = {};
+  bool _visible = true;
+  bool _dirty = true;
+  uint8_t _layer = 0;
+  int32_t _depth = 0;
+  Widget *_parent = nullptr;
+  std::vector<std::shared_ptr<Widget>> _children;
+  std::vector<Fragment> _fragments;
+
+protected:
+  inline void markDirty() { _dirty = true; }
+  virtual void build(RenderSystem *renderSystem,
+                     std::vector<Fragment> &fragments) {}
+  virtual void drawContents(RenderSystem *renderSystem,
+                            const SDL_FPoint &origin) {}
+
+public:
+  inline const SDL_FRect &getRect() const { return _rect; }
+  inline void setRect(const SDL_FRect &rect) {
+    if (rect.w != _rect.w || rect.h != _rect.h) {
+      _dirty = true;
+    }
+    _rect = rect;
+  }
+  inline void setPosition(const SDL_FPoint &position) {
+    _rect.x = position.x;
+    _rect.y = position.y;
+  }
+  inline bool isVisible() const { return _visible; }
+  inline void setVisible(bool visible) { _visible = visible; }
+  inline bool isDirty() const { return _dirty; }
+  inline Widget *getParent() const { return _parent; }
+  inline const std::vector<std::shared_ptr<Widget>> &getChildren() const {
+    return _children;
+  }
+  void addChild(const std::shared_ptr<Widget> &child);
+  void removeChild(const std::shared_ptr<Widget> &child);
+  virtual void update(uint64_t ticks);
+  virtual bool onMouseButtonDown(const SDL_MouseButtonEvent &event,
+                                 const SDL_FPoint &point) {
+    return false;
+  }
+  virtual bool onKeyDown(const SDL_KeyboardEvent &event) { return false; }
+  bool dispatchMouseButtonDown(const SDL_MouseButtonEvent &event,
+                               const SDL_FPoint &point);
+  void draw(RenderSystem *renderSystem, const SDL_FPoint &origin,
+            uint8_t layer, int32_t &depth);
+};
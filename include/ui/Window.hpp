@@ -0,0 +1,55 @@
+#pragma once
+#include "render/Fragment.hpp"
+#include "render/RenderSystem.hpp"
+#include "ui/Widget.hpp"
+#include <SDL3/SDL_rect.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+class Window : public Widget {
+public:
+  static constexpr float BORDER = 16.f;
+  static constexpr float CURSOR_BORDER = 2.f;
+  static constexpr float PADDING = 16.f;
+
+private:
+  std::string _skin;
+  uint8_t _opacity = 255;
+  uint8_t _backOpacity = 192;
+  SDL_FRect _cursorRect = {};
+  bool _cursorDirty = true;
+  std::vector<Fragment> _cursor;
+
+protected:
+  static void addNineSlice(std::vector<Fragment> &fragments, uint32_t texture,
+                           const SDL_FRect &source, float border,
+                           const SDL_FRect &target, uint8_t alpha,
+                           bool center = true);
+  void build(RenderSystem *renderSystem,
+             std::vector<Fragment> &fragments) override;
+  void drawContents(RenderSystem *renderSystem,
+                    const SDL_FPoint &origin) override;
+
+public:
+  inline const std::string &getSkin() const { return _skin; }
+  inline void setSkin(const std::string &skin) {
+    _skin = skin;
+    markDirty();
+    _cursorDirty = true;
+  }
+  inline uint8_t getOpacity() const { return _opacity; }
+  inline void setOpacity(uint8_t opacity) {
+    _opacity = opacity;
+    markDirty();
+  }
+  inline uint8_t getBackOpacity() const { return _backOpacity; }
+  inline void setBackOpacity(uint8_t opacity) {
+    _backOpacity = opacity;
+    markDirty();
+  }
+  inline const SDL_FRect &getCursorRect() const { return _cursorRect; }
+  inline void setCursorRect(const SDL_FRect &rect) {
+    _cursorRect = rect;
+    _cursorDirty = true;
+  }
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include "core/Object.hpp"
+#include <SDL3/SDL_iostream.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+class TileChunk : public Object {
+public:
+  static constexpr uint32_t SIZE = 32;
+  static constexpr uint32_t AREA = SIZE * SIZE;
+  enum class Encoding : uint8_t { UNIFORM, PALETTE, DIRECT };
+
+private:
+  Encoding _encoding = Encoding::UNIFORM;
+  uint8_t _bits = 0;
+  uint16_t _live = 0;
+  uint32_t _uniform = 0;
+  uint32_t _changes = 0;
+  std::vector<uint32_t> _palette;
+  std::vector<uint16_t> _counts;
+  std::vector<uint32_t> _data;
+  uint64_t _revision;
+
+private:
+  static uint64_t nextRevision();
+  inline uint32_t readIndex(uint32_t index) const {
+    auto shift = 5 - _bits;
+    auto offset = (index & ((1u << shift) - 1)) << _bits;
+    auto mask = (1u << (1u << _bits)) - 1;
+    return (_data[index >> shift] >> offset) & mask;
+  }
+  inline void writeIndex(uint32_t index, uint32_t value) {
+    auto shift = 5 - _bits;
+    auto offset = (index & ((1u << shift) - 1)) << _bits;
+    auto mask = (1u << (1u << _bits)) - 1;
+    auto &word = _data[index >> shift];
+    word = (word & ~(mask << offset)) | (value << offset);
+  }
+  uint32_t findPalette(uint32_t tile);
+  void setPaletteTile(uint32_t index, uint32_t tile);
+  void repack(uint8_t bits);
+  void fromTiles(const std::vector<uint32_t> &tiles);
+  void toTiles(std::vector<uint32_t> &tiles) const;
+
+public:
+  TileChunk();
+  inline uint64_t getRevision() const { return _revision; }
+  // Newest revision handed out so far; chunks created or edited later get a
+  // higher one.
+  static uint64_t getLatestRevision();
+  inline Encoding getEncoding() const { return _encoding; }
+  inline bool isEmpty() const {
+    return _encoding == Encoding::UNIFORM && _uniform == 0;
+  }
+  inline uint32_t getTile(uint32_t x, uint32_t y) const {
+    switch (_encoding) {
+    case Encoding::UNIFORM:
+      return _uniform;
+    case Encoding::PALETTE:
+      return _palette[readIndex(y * SIZE + x)];
+    default:
+      return _data[y * SIZE + x];
+    }
+  }
+  void setTile(uint32_t x, uint32_t y, uint32_t tile);
+  void compact();
+  size_t getMemoryUsage() const;
+  bool write(SDL_IOStream *io) const;
+  bool read(SDL_IOStream *io);
+};
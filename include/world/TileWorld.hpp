@@ -0,0 +1,134 @@
+#pragma once
+#include "core/Object.hpp"
+#include "core/ThreadPool.hpp"
+#include "runtime/Logger.hpp"
+#include "world/TileChunk.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+class TileWorld : public Object {
+public:
+  static constexpr int32_t REGION_SIZE = 8;
+  static constexpr int32_t REGION_TILES = REGION_SIZE * TileChunk::SIZE;
+  struct ChunkRecord {
+    int32_t cx;
+    int32_t cy;
+    std::shared_ptr<const TileChunk> chunk;
+  };
+  struct PagedRegion {
+    std::string path;
+    // chunks of the region that belong to the snapshot, one bit each
+    uint64_t mask;
+  };
+  struct Snapshot {
+    std::vector<ChunkRecord> chunks;
+    // Hard links to the region files that were not resident. Region writes
+    // replace files by renaming, so the links keep the snapshot's contents.
+    std::vector<PagedRegion> paged;
+    // Holds only the chunks changed since the previous snapshot, including
+    // ones that became empty.
+    bool changes = false;
+
+    Snapshot() = default;
+    Snapshot(Snapshot &&) = default;
+    Snapshot &operator=(Snapshot &&) = default;
+    ~Snapshot();
+  };
+
+private:
+  // Chunks are shared with snapshots and copied on the first write after one
+  // was taken. Untouched slots all point at the same empty chunk.
+  struct Region {
+    std::vector<std::shared_ptr<TileChunk>> chunks =
+        std::vector<std::shared_ptr<TileChunk>>(REGION_SIZE * REGION_SIZE,
+                                                getEmptyChunk());
+    bool dirty = false;
+    // chunks edited since the last snapshot, one bit each
+    uint64_t changed = 0;
+    uint64_t lastUsed = 0;
+  };
+  struct LoadResult {
+    uint64_t key;
+    std::shared_ptr<Region> region;
+  };
+  struct StoreResult {
+    uint64_t key;
+    Region *region;
+  };
+
+private:
+  std::string _path;
+  std::unordered_map<uint64_t, std::shared_ptr<Region>> _regions;
+  std::unordered_map<uint64_t, std::shared_ptr<Region>> _writeBack;
+  std::unordered_set<uint64_t> _loading;
+  // change bits of regions that were evicted since the last snapshot
+  std::unordered_map<uint64_t, uint64_t> _changed;
+  std::mutex _mutex;
+  std::vector<LoadResult> _loaded;
+  std::vector<StoreResult> _stored;
+  size_t _memoryLimit = 64 * 1024 * 1024;
+  uint32_t _prefetch = 1;
+  uint64_t _frame = 0;
+  bool _overLimit = false;
+  uint64_t _lastKey = UINT64_MAX;
+  Region *_lastRegion = nullptr;
+  std::unique_ptr<ThreadPool> _io;
+
+  Logger *_logger = Logger::getLogger("TileWorld");
+
+private:
+  static const std::shared_ptr<TileChunk> &getEmptyChunk();
+  static TileChunk &detach(std::shared_ptr<TileChunk> &chunk);
+  static uint64_t makeKey(int32_t rx, int32_t ry);
+  std::string getRegionPath(uint64_t key) const;
+  static bool readRegion(const std::string &path, Region &region);
+  static bool writeRegion(const std::string &path, const Region &region);
+  Region *findRegion(uint64_t key);
+  Region *acquireRegion(uint64_t key);
+  void requestLoad(uint64_t key);
+  void requestStore(uint64_t key, const std::shared_ptr<Region> &region);
+  void collect();
+  void evict(const std::unordered_set<uint64_t> &keep);
+  size_t getRegionMemory(const Region &region) const;
+
+public:
+  static int32_t floorDiv(int32_t value, int32_t divisor);
+
+public:
+  TileWorld(const std::string &path = "");
+  ~TileWorld() override;
+  inline const std::string &getPath() const { return _path; }
+  inline size_t getMemoryLimit() const { return _memoryLimit; }
+  inline void setMemoryLimit(size_t limit) { _memoryLimit = limit; }
+  inline uint32_t getPrefetch() const { return _prefetch; }
+  inline void setPrefetch(uint32_t regions) { _prefetch = regions; }
+  inline size_t getResidentRegionCount() const { return _regions.size(); }
+  uint32_t getTile(int32_t x, int32_t y);
+  void setTile(int32_t x, int32_t y, uint32_t tile);
+  const TileChunk *getChunk(int32_t cx, int32_t cy);
+  // Installs a loaded chunk. Unlike setTile, this is not recorded as a change.
+  void setChunk(int32_t cx, int32_t cy, TileChunk &&chunk);
+  // Like setChunk, but keeps the current chunk if it was edited after
+  // `revision`. Returns whether `chunk` was installed.
+  bool loadChunk(int32_t cx, int32_t cy, TileChunk &&chunk, uint64_t revision);
+  // Shares every non-empty resident chunk without copying tile data and
+  // lists the regions paged out to disk. With `changes`, only chunks edited
+  // since the previous snapshot are taken. Either way the change tracking
+  // starts over, so the next delta is relative to this snapshot.
+  Snapshot snapshot(bool changes = false);
+  // Forgets edits made so far, e.g. once the world matches a loaded save.
+  void clearChanges();
+  // Reads the paged regions of `snapshot` into its chunks. Does not touch the
+  // world, so it can run on another thread.
+  static bool loadPaged(Snapshot &snapshot);
+  size_t getMemoryUsage() const;
+  void update(int32_t x, int32_t y, int32_t w, int32_t h);
+  void flush();
+  // Drops every chunk, in memory and in the region directory.
+  void reset();
+};
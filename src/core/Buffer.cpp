@@ -1,39 +1,103 @@
 #include "core/Buffer.hpp"
+#include "core/BufferPool.hpp"
 #include <SDL3/SDL_iostream.h>
-#include <new>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+Buffer::Buffer(Buffer &&other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _capacity(std::exchange(other._capacity, 0)),
+      _alignment(other._alignment) {}
+Buffer &Buffer::operator=(Buffer &&other) noexcept {
+  if (this != &other) {
+    BufferPool::release(_data, _capacity, _alignment);
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+    _capacity = std::exchange(other._capacity, 0);
+    _alignment = other._alignment;
+  }
+  return *this;
+}
 Buffer::~Buffer() {
-  if (_data) {
-    ::operator delete(_data);
-    _data = nullptr;
-    _size = 0;
+  BufferPool::release(_data, _capacity, _alignment);
+  _data = nullptr;
+  _size = 0;
+  _capacity = 0;
+}
+void Buffer::reallocate(size_t capacity, bool preserve) {
+  size_t allocated = 0;
+  void *data = nullptr;
+  if (capacity) {
+    data = BufferPool::allocate(capacity, _alignment, allocated);
+    if (preserve && _size) {
+      memcpy(data, _data, std::min(_size, capacity));
+    }
   }
+  BufferPool::release(_data, _capacity, _alignment);
+  _data = data;
+  _capacity = allocated;
+}
+void Buffer::setAlignment(size_t alignment) {
+  if (alignment == _alignment) {
+    return;
+  }
+  if (!_data) {
+    _alignment = alignment;
+    return;
+  }
+  Buffer aligned;
+  aligned._alignment = alignment;
+  aligned.reset(_size, _data);
+  *this = std::move(aligned);
 }
 void Buffer::reset(size_t size, void *data) {
-  if (_data) {
-    ::operator delete(_data);
-    _data = nullptr;
+  if (size > _capacity) {
+    _size = 0;
+    reallocate(size, false);
   }
   _size = size;
-  if (_size) {
-    _data = ::operator new(size);
-  }
-  if (data) {
+  if (data && size) {
     memcpy(_data, data, size);
   }
 }
-size_t Buffer::write(size_t offset, size_t len, void *data) {
-  size_t size = len;
-  if (size + offset > _size) {
-    size = _size - offset;
+void Buffer::resize(size_t size) {
+  if (size > _capacity) {
+    reallocate(std::max(size, _capacity * 2), true);
+  }
+  if (size > _size) {
+    memset((uint8_t *)_data + _size, 0, size - _size);
+  }
+  _size = size;
+}
+void Buffer::reserve(size_t capacity) {
+  if (capacity > _capacity) {
+    reallocate(capacity, true);
+  }
+}
+void Buffer::append(const void *data, size_t len) {
+  write(_size, len, data);
+}
+void Buffer::shrink() {
+  if (_size < _capacity) {
+    reallocate(_size, true);
   }
-  memcpy((uint8_t *)_data + offset, data, size);
-  return size;
 }
-size_t Buffer::read(size_t offset, size_t len, void *data) {
-  size_t size = len;
-  if (size + offset > _size) {
-    size = _size - offset;
+size_t Buffer::write(size_t offset, size_t len, const void *data) {
+  if (!len) {
+    return 0;
+  }
+  if (offset + len > _size) {
+    resize(offset + len);
   }
+  memcpy((uint8_t *)_data + offset, data, len);
+  return len;
+}
+size_t Buffer::read(size_t offset, size_t len, void *data) const {
+  if (offset >= _size) {
+    return 0;
+  }
+  size_t size = std::min(len, _size - offset);
   memcpy(data, (uint8_t *)_data + offset, size);
   return size;
-}
\ No newline at end of file
+}
@@ -0,0 +1,106 @@
+#include "core/BufferPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <new>
+static thread_local BufferPool *current = nullptr;
+
+BufferPool::~BufferPool() {
+  if (current == this) {
+    current = nullptr;
+  }
+  for (size_t index = 0; index < CLASS_COUNT; ++index) {
+    for (auto data : _classes[index]) {
+      ::operator delete(data, std::align_val_t{ALIGNMENT});
+    }
+  }
+}
+
+BufferPool *BufferPool::getPool() {
+  // `current` stays readable after the pool itself is destroyed at thread
+  // exit, so late releases fall back to the global allocator.
+  static thread_local bool created = false;
+  if (!created) {
+    created = true;
+    static thread_local BufferPool pool;
+    current = &pool;
+  }
+  return current;
+}
+
+size_t BufferPool::getClass(size_t size) {
+  if (size <= MIN_SIZE) {
+    return 0;
+  }
+  auto shift = std::bit_width(size - 1) - 3;
+  auto step = ((size - 1) >> shift) + 1;
+  return (shift - 4) * 4 + step - 4;
+}
+
+size_t BufferPool::getClassSize(size_t index) {
+  if (index == 0) {
+    return MIN_SIZE;
+  }
+  auto shift = (index - 1) / 4 + 4;
+  auto step = (index - 1) % 4 + 5;
+  return step << shift;
+}
+
+void *BufferPool::allocate(size_t size, size_t alignment, size_t &capacity) {
+  if (size > MAX_SIZE || alignment > ALIGNMENT) {
+    capacity = size;
+    return ::operator new(size,
+                          std::align_val_t{std::max(alignment, ALIGNMENT)});
+  }
+  auto index = getClass(size);
+  capacity = getClassSize(index);
+  auto pool = getPool();
+  if (pool && !pool->_classes[index].empty()) {
+    auto data = pool->_classes[index].back();
+    pool->_classes[index].pop_back();
+    pool->_stats.hits++;
+    pool->_stats.cached -= capacity;
+    return data;
+  }
+  if (pool) {
+    pool->_stats.misses++;
+  }
+  return ::operator new(capacity, std::align_val_t{ALIGNMENT});
+}
+
+void BufferPool::release(void *data, size_t capacity, size_t alignment) {
+  if (!data) {
+    return;
+  }
+  if (capacity > MAX_SIZE || alignment > ALIGNMENT) {
+    ::operator delete(data, std::align_val_t{std::max(alignment, ALIGNMENT)});
+    return;
+  }
+  auto pool = getPool();
+  auto index = getClass(capacity);
+  if (pool && pool->_classes[index].size() < MAX_BLOCKS &&
+      pool->_stats.cached + capacity <= MAX_CACHED) {
+    pool->_classes[index].push_back(data);
+    pool->_stats.cached += capacity;
+    return;
+  }
+  ::operator delete(data, std::align_val_t{ALIGNMENT});
+}
+
+void BufferPool::trim() {
+  auto pool = getPool();
+  if (!pool) {
+    return;
+  }
+  for (auto &blocks : pool->_classes) {
+    for (auto data : blocks) {
+      ::operator delete(data, std::align_val_t{ALIGNMENT});
+    }
+    blocks.clear();
+  }
+  pool->_stats.cached = 0;
+}
+
+BufferPool::Stats BufferPool::getStats() {
+  auto pool = getPool();
+  return pool ? pool->_stats : Stats{};
+}
@@ -0,0 +1,190 @@
+#include "core/Compression.hpp"
+#include <SDL3/SDL.h>
+#include <zstd.h>
+namespace {
+struct ContextCache {
+  ZSTD_CCtx *compressor = nullptr;
+  ZSTD_DCtx *decompressor = nullptr;
+  bool compressing = false;
+  bool decompressing = false;
+  ~ContextCache() {
+    ZSTD_freeCCtx(compressor);
+    ZSTD_freeDCtx(decompressor);
+  }
+};
+thread_local ContextCache cache;
+
+ZSTD_CCtx *acquireCompressor() {
+  if (cache.compressing) {
+    return ZSTD_createCCtx();
+  }
+  if (!cache.compressor) {
+    cache.compressor = ZSTD_createCCtx();
+  }
+  cache.compressing = true;
+  return cache.compressor;
+}
+void releaseCompressor(ZSTD_CCtx *context) {
+  if (context == cache.compressor) {
+    cache.compressing = false;
+  } else {
+    ZSTD_freeCCtx(context);
+  }
+}
+ZSTD_DCtx *acquireDecompressor() {
+  if (cache.decompressing) {
+    return ZSTD_createDCtx();
+  }
+  if (!cache.decompressor) {
+    cache.decompressor = ZSTD_createDCtx();
+  }
+  cache.decompressing = true;
+  return cache.decompressor;
+}
+void releaseDecompressor(ZSTD_DCtx *context) {
+  if (context == cache.decompressor) {
+    cache.decompressing = false;
+  } else {
+    ZSTD_freeDCtx(context);
+  }
+}
+
+struct Writer {
+  Buffer &output;
+  Buffer staging;
+  ZSTD_CCtx *context;
+  size_t written = 0;
+  bool failed = false;
+
+  bool pump(ZSTD_inBuffer &input, ZSTD_EndDirective mode) {
+    for (;;) {
+      ZSTD_outBuffer out = {staging.getData(), staging.getSize(), 0};
+      auto remaining = ZSTD_compressStream2(context, &out, &input, mode);
+      if (ZSTD_isError(remaining)) {
+        SDL_SetError("zstd: %s", ZSTD_getErrorName(remaining));
+        failed = true;
+        return false;
+      }
+      output.append(staging.getData(), out.pos);
+      if (mode == ZSTD_e_continue ? input.pos == input.size
+                                  : remaining == 0) {
+        return true;
+      }
+    }
+  }
+};
+
+struct Reader {
+  ZSTD_inBuffer input;
+  ZSTD_DCtx *context;
+  size_t position = 0;
+  bool finished = false;
+};
+
+Sint64 writerSeek(void *userdata, Sint64 offset, SDL_IOWhence whence) {
+  auto writer = static_cast<Writer *>(userdata);
+  if (offset != 0 || whence != SDL_IO_SEEK_CUR) {
+    SDL_SetError("Compressed streams cannot seek");
+    return -1;
+  }
+  return writer->written;
+}
+size_t writerWrite(void *userdata, const void *ptr, size_t size,
+                   SDL_IOStatus *status) {
+  auto writer = static_cast<Writer *>(userdata);
+  ZSTD_inBuffer input = {ptr, size, 0};
+  if (writer->failed || !writer->pump(input, ZSTD_e_continue)) {
+    *status = SDL_IO_STATUS_ERROR;
+    return 0;
+  }
+  writer->written += size;
+  return size;
+}
+bool writerClose(void *userdata) {
+  auto writer = static_cast<Writer *>(userdata);
+  ZSTD_inBuffer input = {nullptr, 0, 0};
+  bool ok = !writer->failed && writer->pump(input, ZSTD_e_end);
+  releaseCompressor(writer->context);
+  delete writer;
+  return ok;
+}
+
+Sint64 readerSeek(void *userdata, Sint64 offset, SDL_IOWhence whence) {
+  auto reader = static_cast<Reader *>(userdata);
+  if (offset != 0 || whence != SDL_IO_SEEK_CUR) {
+    SDL_SetError("Compressed streams cannot seek");
+    return -1;
+  }
+  return reader->position;
+}
+size_t readerRead(void *userdata, void *ptr, size_t size,
+                  SDL_IOStatus *status) {
+  auto reader = static_cast<Reader *>(userdata);
+  ZSTD_outBuffer out = {ptr, size, 0};
+  while (out.pos < size && !reader->finished) {
+    auto before = out.pos;
+    auto consumed = reader->input.pos;
+    auto result = ZSTD_decompressStream(reader->context, &out, &reader->input);
+    if (ZSTD_isError(result)) {
+      SDL_SetError("zstd: %s", ZSTD_getErrorName(result));
+      *status = SDL_IO_STATUS_ERROR;
+      break;
+    }
+    if (result == 0) {
+      reader->finished = true;
+    } else if (out.pos == before && reader->input.pos == consumed) {
+      SDL_SetError("zstd: truncated frame");
+      *status = SDL_IO_STATUS_ERROR;
+      break;
+    }
+  }
+  if (out.pos < size && reader->finished) {
+    *status = SDL_IO_STATUS_EOF;
+  }
+  reader->position += out.pos;
+  return out.pos;
+}
+bool readerClose(void *userdata) {
+  auto reader = static_cast<Reader *>(userdata);
+  releaseDecompressor(reader->context);
+  delete reader;
+  return true;
+}
+} // namespace
+
+SDL_IOStream *Compression::openWriter(Buffer &output, int level) {
+  auto context = acquireCompressor();
+  ZSTD_CCtx_reset(context, ZSTD_reset_session_and_parameters);
+  ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level);
+  ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+  auto writer = new Writer{output, {}, context};
+  writer->staging.reset(ZSTD_CStreamOutSize());
+  SDL_IOStreamInterface iface;
+  SDL_INIT_INTERFACE(&iface);
+  iface.seek = writerSeek;
+  iface.write = writerWrite;
+  iface.close = writerClose;
+  auto stream = SDL_OpenIO(&iface, writer);
+  if (!stream) {
+    releaseCompressor(context);
+    delete writer;
+  }
+  return stream;
+}
+
+SDL_IOStream *Compression::openReader(const void *data, size_t size) {
+  auto context = acquireDecompressor();
+  ZSTD_DCtx_reset(context, ZSTD_reset_session_only);
+  auto reader = new Reader{{data, size, 0}, context};
+  SDL_IOStreamInterface iface;
+  SDL_INIT_INTERFACE(&iface);
+  iface.seek = readerSeek;
+  iface.read = readerRead;
+  iface.close = readerClose;
+  auto stream = SDL_OpenIO(&iface, reader);
+  if (!stream) {
+    releaseDecompressor(context);
+    delete reader;
+  }
+  return stream;
+}
@@ -0,0 +1,97 @@
+#include "core/PixelKernels.hpp"
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PIXEL_KERNELS_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PIXEL_KERNELS_NEON
+#endif
+
+static inline uint8_t multiply(uint8_t value, uint8_t alpha) {
+  uint32_t product = value * alpha + 128;
+  return static_cast<uint8_t>((product + (product >> 8)) >> 8);
+}
+
+void swizzleRedBlue(const void *src, void *dst, size_t pixels) {
+  auto in = static_cast<const uint8_t *>(src);
+  auto out = static_cast<uint8_t *>(dst);
+  size_t index = 0;
+#if defined(PIXEL_KERNELS_SSE2)
+  const __m128i keep = _mm_set1_epi32(0xff00ff00);
+  const __m128i low = _mm_set1_epi32(0x000000ff);
+  for (; index + 4 <= pixels; index += 4) {
+    auto px =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + index * 4));
+    auto swapped = _mm_or_si128(
+        _mm_and_si128(px, keep),
+        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(px, 16), low),
+                     _mm_slli_epi32(_mm_and_si128(px, low), 16)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + index * 4), swapped);
+  }
+#elif defined(PIXEL_KERNELS_NEON)
+  for (; index + 16 <= pixels; index += 16) {
+    auto px = vld4q_u8(in + index * 4);
+    auto red = px.val[0];
+    px.val[0] = px.val[2];
+    px.val[2] = red;
+    vst4q_u8(out + index * 4, px);
+  }
+#endif
+  for (; index < pixels; ++index) {
+    auto pixel = in + index * 4;
+    uint8_t swapped[4] = {pixel[2], pixel[1], pixel[0], pixel[3]};
+    memcpy(out + index * 4, swapped, 4);
+  }
+}
+
+void premultiplyAlpha(const void *src, void *dst, size_t pixels) {
+  auto in = static_cast<const uint8_t *>(src);
+  auto out = static_cast<uint8_t *>(dst);
+  size_t index = 0;
+#if defined(PIXEL_KERNELS_SSE2)
+  // x / 255 ~= (t + (t >> 8)) >> 8 with t = x + 128, exact for x <= 255 * 255
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i opaque = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+  const __m128i half = _mm_set1_epi16(128);
+  auto scale = [&](__m128i channels) {
+    auto alpha = _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3)),
+        _MM_SHUFFLE(3, 3, 3, 3));
+    auto product = _mm_add_epi16(
+        _mm_mullo_epi16(channels, _mm_or_si128(alpha, opaque)), half);
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)),
+                          8);
+  };
+  for (; index + 4 <= pixels; index += 4) {
+    auto px =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + index * 4));
+    auto lo = scale(_mm_unpacklo_epi8(px, zero));
+    auto hi = scale(_mm_unpackhi_epi8(px, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + index * 4),
+                     _mm_packus_epi16(lo, hi));
+  }
+#elif defined(PIXEL_KERNELS_NEON)
+  auto scale = [](uint8x16_t channel, uint8x16_t alpha) {
+    auto lo = vmull_u8(vget_low_u8(channel), vget_low_u8(alpha));
+    auto hi = vmull_u8(vget_high_u8(channel), vget_high_u8(alpha));
+    return vcombine_u8(vrshrn_n_u16(vrsraq_n_u16(lo, lo, 8), 8),
+                       vrshrn_n_u16(vrsraq_n_u16(hi, hi, 8), 8));
+  };
+  for (; index + 16 <= pixels; index += 16) {
+    auto px = vld4q_u8(in + index * 4);
+    px.val[0] = scale(px.val[0], px.val[3]);
+    px.val[1] = scale(px.val[1], px.val[3]);
+    px.val[2] = scale(px.val[2], px.val[3]);
+    vst4q_u8(out + index * 4, px);
+  }
+#endif
+  for (; index < pixels; ++index) {
+    auto pixel = in + index * 4;
+    auto alpha = pixel[3];
+    uint8_t scaled[4] = {multiply(pixel[0], alpha), multiply(pixel[1], alpha),
+                         multiply(pixel[2], alpha), alpha};
+    memcpy(out + index * 4, scaled, 4);
+  }
+}
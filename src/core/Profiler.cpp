@@ -0,0 +1,147 @@
+#include "core/Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <format>
+std::atomic<bool> Profiler::_enabled = false;
+std::mutex Profiler::_mutex;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::_threads;
+
+Profiler::ThreadBuffer::~ThreadBuffer() {
+  for (auto &chunk : chunks) {
+    delete[] chunk.load();
+  }
+}
+
+// name given before the thread registered, e.g. by pool workers that may
+// never record anything
+static thread_local std::string threadName;
+
+Profiler::ThreadBuffer *Profiler::getThreadBuffer(bool create) {
+  // buffers belong to the registry so they outlive their thread
+  thread_local ThreadBuffer *buffer = nullptr;
+  if (!buffer && create) {
+    std::unique_lock lock(_mutex);
+    auto &thread = _threads.emplace_back(std::make_unique<ThreadBuffer>());
+    thread->id = static_cast<uint32_t>(_threads.size());
+    thread->name = threadName.empty() ? std::format("Thread {}", thread->id)
+                                      : threadName;
+    buffer = thread.get();
+  }
+  return buffer;
+}
+
+void Profiler::record(const char *name, char phase, uint64_t time,
+                      int64_t value) {
+  auto buffer = getThreadBuffer();
+  auto index = buffer->count.load(std::memory_order_relaxed);
+  auto chunkIndex = index / CHUNK_SIZE;
+  if (chunkIndex >= MAX_CHUNKS) {
+    buffer->dropped++;
+    return;
+  }
+  auto chunk = buffer->chunks[chunkIndex].load(std::memory_order_relaxed);
+  if (!chunk) {
+    chunk = new Event[CHUNK_SIZE];
+    buffer->chunks[chunkIndex].store(chunk, std::memory_order_release);
+  }
+  chunk[index % CHUNK_SIZE] = {name, phase, time, value};
+  buffer->count.store(index + 1, std::memory_order_release);
+}
+
+uint64_t Profiler::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Profiler::start() { _enabled.store(true); }
+void Profiler::stop() { _enabled.store(false); }
+
+void Profiler::setThreadName(const std::string &name) {
+  threadName = name;
+  auto buffer = getThreadBuffer(false);
+  if (buffer) {
+    std::unique_lock lock(_mutex);
+    buffer->name = name;
+  }
+}
+
+static void writeString(std::string &output, const char *text) {
+  output.push_back('"');
+  for (auto ch = text; *ch; ++ch) {
+    if (*ch == '"' || *ch == '\\') {
+      output.push_back('\\');
+    }
+    output.push_back(*ch);
+  }
+  output.push_back('"');
+}
+
+bool Profiler::exportTrace(const std::string &path) {
+  auto file = fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  std::unique_lock lock(_mutex);
+  uint64_t origin = UINT64_MAX;
+  for (auto &thread : _threads) {
+    auto count = thread->count.load(std::memory_order_acquire);
+    for (size_t index = 0; index < count; ++index) {
+      auto &event = thread->chunks[index / CHUNK_SIZE].load(
+          std::memory_order_acquire)[index % CHUNK_SIZE];
+      origin = std::min(origin, event.time);
+    }
+  }
+  std::string output = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto separate = [&] {
+    if (!first) {
+      output.push_back(',');
+    }
+    first = false;
+  };
+  for (auto &thread : _threads) {
+    separate();
+    std::format_to(std::back_inserter(output),
+                   "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                   "\"tid\":{},\"args\":{{\"name\":",
+                   thread->id);
+    writeString(output, thread->name.c_str());
+    output += "}}";
+    auto count = thread->count.load(std::memory_order_acquire);
+    for (size_t index = 0; index < count; ++index) {
+      auto &event = thread->chunks[index / CHUNK_SIZE].load(
+          std::memory_order_acquire)[index % CHUNK_SIZE];
+      separate();
+      output += "{\"name\":";
+      writeString(output, event.name);
+      auto time = (event.time - origin) / 1000.0;
+      switch (event.phase) {
+      case 'X':
+        std::format_to(std::back_inserter(output),
+                       ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f}", time,
+                       event.value / 1000.0);
+        break;
+      case 'C':
+        std::format_to(std::back_inserter(output),
+                       ",\"ph\":\"C\",\"ts\":{:.3f},\"args\":{{\"value\":{}}}",
+                       time, event.value);
+        break;
+      default:
+        std::format_to(std::back_inserter(output),
+                       ",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f}", time);
+        break;
+      }
+      std::format_to(std::back_inserter(output), ",\"pid\":1,\"tid\":{}}}",
+                     thread->id);
+      if (output.size() >= 1024 * 1024) {
+        fwrite(output.data(), 1, output.size(), file);
+        output.clear();
+      }
+    }
+  }
+  output += "]}\n";
+  bool ok = fwrite(output.data(), 1, output.size(), file) == output.size();
+  return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,59 @@
+#include "core/ThreadPool.hpp"
+#include "core/Profiler.hpp"
+#include <algorithm>
+ThreadPool::ThreadPool(size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    _workers.emplace_back([this] { work(); });
+  }
+}
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock lock(_mutex);
+    _stopping = true;
+  }
+  _ready.notify_all();
+  for (auto &worker : _workers) {
+    worker.join();
+  }
+}
+void ThreadPool::work() {
+  Profiler::setThreadName("Worker");
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(_mutex);
+      _ready.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+      if (_tasks.empty()) {
+        return;
+      }
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+      _active++;
+    }
+    {
+      PROFILE_ZONE("ThreadPool::task");
+      task();
+    }
+    {
+      std::unique_lock lock(_mutex);
+      _active--;
+      if (_tasks.empty() && _active == 0) {
+        _idle.notify_all();
+      }
+    }
+  }
+}
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::unique_lock lock(_mutex);
+    _tasks.push_back(std::move(task));
+  }
+  _ready.notify_one();
+}
+void ThreadPool::wait() {
+  std::unique_lock lock(_mutex);
+  _idle.wait(lock, [this] { return _tasks.empty() && _active == 0; });
+}
@@ -0,0 +1,181 @@
+#include "render/Autotile.hpp"
+#include "render/Image.hpp"
+#include "runtime/Application.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <memory>
+// Quarter tiles (top-left, top-right, bottom-left, bottom-right) of each
+// variant, numbered 1..48 row by row over the 6x8 quarter grid of an RPG
+// Maker XP autotile frame.
+static constexpr uint8_t QUARTERS[Autotile::VARIANTS][4] = {
+    {27, 28, 33, 34}, {5, 28, 33, 34},  {27, 6, 33, 34},  {5, 6, 33, 34},
+    {27, 28, 33, 12}, {5, 28, 33, 12},  {27, 6, 33, 12},  {5, 6, 33, 12},
+    {27, 28, 11, 34}, {5, 28, 11, 34},  {27, 6, 11, 34},  {5, 6, 11, 34},
+    {27, 28, 11, 12}, {5, 28, 11, 12},  {27, 6, 11, 12},  {5, 6, 11, 12},
+    {25, 26, 31, 32}, {25, 6, 31, 32},  {25, 26, 31, 12}, {25, 6, 31, 12},
+    {15, 16, 21, 22}, {15, 16, 21, 12}, {15, 16, 11, 22}, {15, 16, 11, 12},
+    {29, 30, 35, 36}, {29, 30, 11, 36}, {5, 30, 35, 36},  {5, 30, 11, 36},
+    {39, 40, 45, 46}, {5, 40, 45, 46},  {39, 6, 45, 46},  {5, 6, 45, 46},
+    {25, 30, 31, 36}, {15, 16, 45, 46}, {13, 14, 19, 20}, {13, 14, 19, 12},
+    {17, 18, 23, 24}, {17, 18, 11, 24}, {41, 42, 47, 48}, {5, 42, 47, 48},
+    {37, 38, 43, 44}, {37, 6, 43, 44},  {13, 18, 19, 24}, {13, 14, 43, 44},
+    {37, 42, 43, 48}, {17, 18, 47, 48}, {13, 18, 43, 48}, {1, 2, 7, 8},
+};
+
+uint8_t Autotile::getVariant(uint8_t mask) {
+  bool n = mask & NORTH;
+  bool e = mask & EAST;
+  bool s = mask & SOUTH;
+  bool w = mask & WEST;
+  uint8_t ne = (mask & NORTH_EAST) ? 0 : 1;
+  uint8_t se = (mask & SOUTH_EAST) ? 0 : 1;
+  uint8_t sw = (mask & SOUTH_WEST) ? 0 : 1;
+  uint8_t nw = (mask & NORTH_WEST) ? 0 : 1;
+  switch ((n ? 1 : 0) | (e ? 2 : 0) | (s ? 4 : 0) | (w ? 8 : 0)) {
+  case 15:
+    return nw | (ne << 1) | (se << 2) | (sw << 3);
+  case 7:
+    return 16 | ne | (se << 1);
+  case 14:
+    return 20 | se | (sw << 1);
+  case 13:
+    return 24 | sw | (nw << 1);
+  case 11:
+    return 28 | nw | (ne << 1);
+  case 5:
+    return 32;
+  case 10:
+    return 33;
+  case 6:
+    return 34 | se;
+  case 12:
+    return 36 | sw;
+  case 9:
+    return 38 | nw;
+  case 3:
+    return 40 | ne;
+  case 4:
+    return 42;
+  case 2:
+    return 43;
+  case 1:
+    return 44;
+  case 8:
+    return 45;
+  default:
+    return 46;
+  }
+}
+
+void Autotile::compose(SDL_Surface *source, SDL_Surface *atlas, uint32_t kind,
+                       uint32_t frames) {
+  int tile = static_cast<int>(_tileSize);
+  int half = tile / 2;
+  bool complete = source->h >= tile * 4;
+  for (uint32_t frame = 0; frame < frames; ++frame) {
+    int frameX = frame * (complete ? tile * 3 : tile);
+    int atlasX = frame * COLUMNS * tile;
+    int atlasY = kind * ROWS * tile;
+    for (uint32_t variant = 0; variant < VARIANTS; ++variant) {
+      int x = atlasX + (variant % COLUMNS) * tile;
+      int y = atlasY + (variant / COLUMNS) * tile;
+      if (!complete) {
+        SDL_Rect src = {frameX, 0, tile, tile};
+        SDL_Rect dst = {x, y, tile, tile};
+        SDL_BlitSurface(source, &src, atlas, &dst);
+        continue;
+      }
+      for (int i = 0; i < 4; ++i) {
+        int quarter = QUARTERS[variant][i] - 1;
+        SDL_Rect src = {frameX + (quarter % 6) * half, (quarter / 6) * half,
+                        half, half};
+        SDL_Rect dst = {x + (i % 2) * half, y + (i / 2) * half, half, half};
+        SDL_BlitSurface(source, &src, atlas, &dst);
+      }
+    }
+  }
+}
+
+bool Autotile::build(RenderSystem *renderSystem, const std::string &texture,
+                     const std::vector<std::string> &images,
+                     uint32_t tileSize) {
+  if (tileSize < 2 || tileSize % 2) {
+    _logger->error("Invalid autotile size {} for '{}'", tileSize, texture);
+    return false;
+  }
+  auto assetManager = Application::getInstance()->getAssetManager();
+  std::vector<std::shared_ptr<Image>> sources;
+  for (auto &name : images) {
+    auto image = std::dynamic_pointer_cast<Image>(assetManager->query(name));
+    if (!image || !image->getSurface()) {
+      _logger->error("Failed to load autotile '{}'", name);
+      return false;
+    }
+    sources.push_back(image);
+  }
+  if (sources.empty()) {
+    return false;
+  }
+  std::vector<uint32_t> kinds;
+  uint32_t maxFrames = 1;
+  for (size_t index = 0; index < sources.size(); ++index) {
+    auto surface = sources[index]->getSurface();
+    auto width = static_cast<uint32_t>(surface->w);
+    auto height = static_cast<uint32_t>(surface->h);
+    bool complete = height >= tileSize * 4;
+    uint32_t frameWidth = complete ? tileSize * 3 : tileSize;
+    if (height < tileSize || width < frameWidth || width % frameWidth) {
+      _logger->error("Autotile '{}' is {}x{}, not a multiple of {}x{} frames",
+                     images[index], width, height, frameWidth,
+                     complete ? tileSize * 4 : tileSize);
+      return false;
+    }
+    kinds.push_back(width / frameWidth);
+    maxFrames = std::max(maxFrames, kinds.back());
+  }
+  _tileSize = tileSize;
+  _frames.swap(kinds);
+  SDL_Surface *atlas =
+      SDL_CreateSurface(maxFrames * COLUMNS * _tileSize,
+                        sources.size() * ROWS * _tileSize,
+                        SDL_PIXELFORMAT_RGBA32);
+  if (!atlas) {
+    _logger->error("Failed to create autotile atlas '{}': {}", texture,
+                   SDL_GetError());
+    return false;
+  }
+  for (uint32_t kind = 0; kind < sources.size(); ++kind) {
+    auto surface = sources[kind]->getSurface();
+    SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+    SDL_GetSurfaceBlendMode(surface, &mode);
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    compose(surface, atlas, kind, _frames[kind]);
+    SDL_SetSurfaceBlendMode(surface, mode);
+  }
+  auto result = renderSystem->createTexture(texture, atlas);
+  SDL_DestroySurface(atlas);
+  if (!result) {
+    return false;
+  }
+  _texture = texture;
+  std::vector<uint16_t> animations;
+  for (uint32_t kind = 0; kind < _frames.size(); ++kind) {
+    auto frames = _frames[kind];
+    uint16_t animation = kind < _animations.size() ? _animations[kind] : 0;
+    if (frames > 1) {
+      SDL_FPoint stride = {static_cast<float>(COLUMNS * _tileSize), 0};
+      if (animation) {
+        renderSystem->setAnimation(animation, frames, frames * _frameDuration,
+                                   stride);
+      } else {
+        animation = renderSystem->createAnimation(
+            frames, frames * _frameDuration, stride);
+      }
+    } else if (animation) {
+      renderSystem->setAnimation(animation, 1, 0, {});
+    }
+    animations.push_back(animation);
+  }
+  _animations.swap(animations);
+  return true;
+}
@@ -0,0 +1,156 @@
+#include "render/EffectPlayer.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+static constexpr uint32_t DEAD = UINT32_MAX;
+
+EffectPlayer::EffectPlayer(size_t capacity) {
+  _instances.resize(capacity);
+  _active.reserve(capacity);
+  _free.reserve(capacity);
+  for (size_t index = capacity; index > 0; --index) {
+    auto &instance = _instances[index - 1];
+    instance.animation = DEAD;
+    instance.generation = 1;
+    _free.push_back(index - 1);
+  }
+  _fragments.reserve(capacity * 4);
+}
+
+uint32_t EffectPlayer::createAnimation(
+    RenderSystem *renderSystem, const std::string &texture,
+    const std::vector<std::vector<Cell>> &frames, uint32_t frameDuration,
+    uint32_t cellSize, uint32_t columns) {
+  if (frames.empty() || !cellSize || !columns) {
+    _logger->error("Invalid effect animation '{}'", texture);
+    return DEAD;
+  }
+  Animation animation = {
+      renderSystem->getTextureHandle(texture),
+      static_cast<float>(cellSize),
+      columns,
+      std::max(frameDuration, 1u),
+      static_cast<uint32_t>(_frames.size()),
+      static_cast<uint32_t>(frames.size()),
+  };
+  for (auto &cells : frames) {
+    _frames.push_back({static_cast<uint32_t>(_cells.size()),
+                       static_cast<uint32_t>(cells.size())});
+    _cells.insert(_cells.end(), cells.begin(), cells.end());
+  }
+  _animations.push_back(animation);
+  return _animations.size() - 1;
+}
+
+uint64_t EffectPlayer::spawn(uint32_t animation, const SDL_FPoint &position,
+                             uint64_t ticks, int32_t zIndex, uint8_t layer,
+                             bool loop) {
+  if (animation >= _animations.size() || _free.empty()) {
+    return 0;
+  }
+  auto slot = _free.back();
+  _free.pop_back();
+  auto &instance = _instances[slot];
+  instance.animation = animation;
+  instance.start = ticks;
+  instance.position = position;
+  instance.zIndex = zIndex;
+  instance.layer = layer;
+  instance.loop = loop;
+  instance.frame = 0;
+  _active.push_back(slot);
+  return (static_cast<uint64_t>(instance.generation) << 32) | slot;
+}
+
+void EffectPlayer::stop(uint64_t effect) {
+  auto slot = static_cast<uint32_t>(effect & 0xffffffff);
+  if (isPlaying(effect)) {
+    _instances[slot].animation = DEAD;
+  }
+}
+
+bool EffectPlayer::isPlaying(uint64_t effect) const {
+  auto slot = static_cast<uint32_t>(effect & 0xffffffff);
+  if (slot >= _instances.size()) {
+    return false;
+  }
+  auto &instance = _instances[slot];
+  return instance.animation != DEAD &&
+         instance.generation == static_cast<uint32_t>(effect >> 32);
+}
+
+void EffectPlayer::setPosition(uint64_t effect, const SDL_FPoint &position) {
+  if (isPlaying(effect)) {
+    _instances[effect & 0xffffffff].position = position;
+  }
+}
+
+void EffectPlayer::clear() {
+  for (auto slot : _active) {
+    _instances[slot].animation = DEAD;
+  }
+  update(0);
+}
+
+void EffectPlayer::update(uint64_t ticks) {
+  size_t count = 0;
+  for (auto slot : _active) {
+    auto &instance = _instances[slot];
+    if (instance.animation != DEAD) {
+      auto &animation = _animations[instance.animation];
+      auto frame = ticks > instance.start
+                       ? (ticks - instance.start) / animation.frameDuration
+                       : 0;
+      if (frame >= animation.frameCount) {
+        if (instance.loop) {
+          frame %= animation.frameCount;
+        } else {
+          instance.animation = DEAD;
+        }
+      }
+      instance.frame = static_cast<uint32_t>(frame);
+    }
+    if (instance.animation == DEAD) {
+      instance.generation++;
+      _free.push_back(slot);
+    } else {
+      _active[count++] = slot;
+    }
+  }
+  _active.resize(count);
+}
+
+void EffectPlayer::draw(RenderSystem *renderSystem,
+                        const SDL_FPoint &offset) {
+  _fragments.clear();
+  for (auto slot : _active) {
+    auto &instance = _instances[slot];
+    if (instance.animation == DEAD) {
+      continue;
+    }
+    auto &animation = _animations[instance.animation];
+    auto &frame = _frames[animation.firstFrame + instance.frame];
+    auto cells = &_cells[frame.firstCell];
+    for (uint32_t index = 0; index < frame.cellCount; ++index) {
+      auto &cell = cells[index];
+      auto size = animation.cellSize * cell.zoom;
+      auto &fragment = _fragments.emplace_back();
+      fragment.setTexture(animation.texture);
+      fragment.setLayer(instance.layer);
+      fragment.setZIndex(instance.zIndex);
+      fragment.setRect({instance.position.x + cell.x - size / 2,
+                        instance.position.y + cell.y - size / 2, size, size});
+      fragment.setClipRect({(cell.pattern % animation.columns) *
+                                animation.cellSize,
+                            (cell.pattern / animation.columns) *
+                                animation.cellSize,
+                            animation.cellSize, animation.cellSize});
+      fragment.setRotate({size / 2, size / 2}, cell.angle);
+      if (cell.mirror) {
+        fragment.setFlipMode(SDL_FLIP_HORIZONTAL);
+      }
+      fragment.setAlpha(cell.opacity);
+      fragment.setBlendMode(cell.blend);
+    }
+  }
+  renderSystem->draw(_fragments.data(), _fragments.size(), offset);
+}
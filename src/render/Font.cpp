@@ -0,0 +1,29 @@
+#include "render/Font.hpp"
+#include "runtime/Application.hpp"
+#include <SDL3/SDL.h>
+Font::~Font() {
+  auto renderSystem = Application::getInstance()->getRenderSystem();
+  for (auto &[_, font] : _fonts) {
+    if (!font) {
+      continue;
+    }
+    if (renderSystem) {
+      renderSystem->getGlyphAtlas()->forget(font);
+    }
+    TTF_CloseFont(font);
+  }
+  _fonts.clear();
+}
+TTF_Font *Font::getFont(float size) {
+  auto it = _fonts.find(size);
+  if (it != _fonts.end()) {
+    return it->second;
+  }
+  auto io = SDL_IOFromConstMem(_data.getData(), _data.getSize());
+  auto font = io ? TTF_OpenFontIO(io, true, size) : nullptr;
+  if (!font) {
+    _logger->error("Failed to open font at size {}: {}", size, SDL_GetError());
+  }
+  _fonts[size] = font;
+  return font;
+}
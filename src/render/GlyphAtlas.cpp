@@ -0,0 +1,111 @@
+#include "render/GlyphAtlas.hpp"
+#include "render/RenderSystem.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <format>
+bool GlyphAtlas::allocate(RenderSystem *renderSystem, int w, int h,
+                          Page *&page, SDL_Rect &rect) {
+  if (w > PAGE_SIZE || h > PAGE_SIZE) {
+    return false;
+  }
+  for (auto &candidate : _pages) {
+    if (candidate.shelfX + w > PAGE_SIZE) {
+      candidate.shelfX = 0;
+      candidate.shelfY += candidate.shelfHeight;
+      candidate.shelfHeight = 0;
+    }
+    if (candidate.shelfY + h > PAGE_SIZE) {
+      continue;
+    }
+    rect = {candidate.shelfX, candidate.shelfY, w, h};
+    candidate.shelfX += w + 1;
+    candidate.shelfHeight = std::max(candidate.shelfHeight, h + 1);
+    page = &candidate;
+    return true;
+  }
+  if (_pages.size() >= MAX_PAGES) {
+    return false;
+  }
+  auto name = std::format("system.glyph.{}", _pages.size());
+  auto texture = renderSystem->createTexture(name, PAGE_SIZE, PAGE_SIZE);
+  if (!texture) {
+    return false;
+  }
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  _pages.push_back({renderSystem->getTextureHandle(name)});
+  auto &fresh = _pages.back();
+  rect = {0, 0, w, h};
+  fresh.shelfX = w + 1;
+  fresh.shelfHeight = h + 1;
+  page = &fresh;
+  return true;
+}
+
+const GlyphAtlas::Glyph *GlyphAtlas::getGlyph(RenderSystem *renderSystem,
+                                              TTF_Font *font,
+                                              uint32_t codepoint) {
+  auto &glyphs = _glyphs[font];
+  auto it = glyphs.find(codepoint);
+  if (it != glyphs.end()) {
+    return &it->second;
+  }
+  Glyph glyph;
+  int advance = 0;
+  TTF_GetGlyphMetrics(font, codepoint, nullptr, nullptr, nullptr, nullptr,
+                      &advance);
+  glyph.advance = static_cast<float>(advance);
+  auto rendered =
+      TTF_RenderGlyph_Blended(font, codepoint, {255, 255, 255, 255});
+  if (rendered) {
+    auto surface = SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(rendered);
+    Page *page = nullptr;
+    SDL_Rect rect;
+    if (surface && (surface->w > PAGE_SIZE || surface->h > PAGE_SIZE)) {
+      _logger->warn("Glyph {} is larger than a glyph page: {}x{}", codepoint,
+                    surface->w, surface->h);
+    } else if (surface && !allocate(renderSystem, surface->w, surface->h,
+                                    page, rect)) {
+      // Fragments submitted this frame may still point into the pages, so
+      // the glyph stays blank until the atlas is cleared between frames.
+      _full = true;
+    }
+    if (surface && page) {
+      auto texture = renderSystem->getTexture(page->texture);
+      if (texture &&
+          SDL_UpdateTexture(texture, &rect, surface->pixels, surface->pitch)) {
+        glyph.texture = page->texture;
+        glyph.clipRect = {static_cast<float>(rect.x),
+                          static_cast<float>(rect.y),
+                          static_cast<float>(rect.w),
+                          static_cast<float>(rect.h)};
+      }
+    }
+    if (surface) {
+      SDL_DestroySurface(surface);
+    }
+  }
+  return &(_glyphs[font][codepoint] = glyph);
+}
+
+void GlyphAtlas::forget(TTF_Font *font) {
+  _glyphs.erase(font);
+  _generation++;
+}
+
+void GlyphAtlas::beginFrame() {
+  if (_full) {
+    _full = false;
+    clear();
+  }
+}
+
+void GlyphAtlas::clear() {
+  _glyphs.clear();
+  for (auto &page : _pages) {
+    page.shelfX = 0;
+    page.shelfY = 0;
+    page.shelfHeight = 0;
+  }
+  _generation++;
+}
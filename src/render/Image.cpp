@@ -4,10 +4,18 @@ Image::Image(SDL_Surface *surface) : _surface(surface) {}
 
 Image::Image(uint32_t w, uint32_t h, SDL_PixelFormat format, void *data) {
   _surface = SDL_CreateSurface(w, h, format);
-  memcpy(_surface->pixels, data, _surface->pitch * h);
+  if (!_surface || !data) {
+    return;
+  }
+  auto row = static_cast<size_t>(SDL_BYTESPERPIXEL(format)) * w;
+  for (uint32_t y = 0; y < h; ++y) {
+    memcpy(static_cast<uint8_t *>(_surface->pixels) + y * _surface->pitch,
+           static_cast<const uint8_t *>(data) + y * row, row);
+  }
 }
 
 Image::~Image() {
+  wait();
   if (_surface) {
     SDL_DestroySurface(_surface);
     _surface = nullptr;
@@ -15,8 +23,32 @@ Image::~Image() {
 }
 
 void Image::setSurface(SDL_Surface *surface) {
+  wait();
   if (_surface) {
     SDL_DestroySurface(_surface);
   }
   _surface = surface;
-}
\ No newline at end of file
+}
+
+void Image::wait() const {
+  std::unique_lock lock(_mutex);
+  _decoded.wait(lock, [this] { return isReady(); });
+}
+
+void Image::beginDecode() {
+  wait();
+  if (_surface) {
+    SDL_DestroySurface(_surface);
+    _surface = nullptr;
+  }
+  _ready.store(false, std::memory_order_release);
+}
+
+void Image::endDecode(SDL_Surface *surface) {
+  {
+    std::unique_lock lock(_mutex);
+    _surface = surface;
+    _ready.store(true, std::memory_order_release);
+  }
+  _decoded.notify_all();
+}
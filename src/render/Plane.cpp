@@ -0,0 +1,127 @@
+#include "render/Plane.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <format>
+Plane::Plane() {
+  static std::atomic<uint32_t> id = 0;
+  _id = id++;
+}
+
+uint32_t Plane::prepareCache(RenderSystem *renderSystem, uint32_t image,
+                             const SDL_Texture *texture) {
+  // repeat the image until it covers the viewport, so any scroll offset
+  // needs at most four quads
+  auto columns = static_cast<int>(std::ceil(_viewport.w / texture->w));
+  auto rows = static_cast<int>(std::ceil(_viewport.h / texture->h));
+  if (columns <= 1 && rows <= 1) {
+    return image;
+  }
+  SDL_Point size = {std::max(columns, 1) * texture->w,
+                    std::max(rows, 1) * texture->h};
+  if (_cache && _cacheImage == _image && _cacheSize.x == size.x &&
+      _cacheSize.y == size.y) {
+    return _cache;
+  }
+  auto name = std::format("system.plane.{}", _id);
+  auto cache = renderSystem->createTexture(name, size.x, size.y,
+                                           SDL_PIXELFORMAT_RGBA32,
+                                           SDL_TEXTUREACCESS_TARGET);
+  if (!cache) {
+    return image;
+  }
+  SDL_SetTextureBlendMode(cache, SDL_BLENDMODE_BLEND);
+  std::vector<Fragment> tiles;
+  for (int y = 0; y < size.y; y += texture->h) {
+    for (int x = 0; x < size.x; x += texture->w) {
+      auto &tile = tiles.emplace_back();
+      tile.setTexture(image);
+      tile.setRect({static_cast<float>(x), static_cast<float>(y),
+                    static_cast<float>(texture->w),
+                    static_cast<float>(texture->h)});
+      tile.setClipRect({0, 0, static_cast<float>(texture->w),
+                        static_cast<float>(texture->h)});
+    }
+  }
+  _cache = renderSystem->getTextureHandle(name);
+  if (!renderSystem->renderToTexture(_cache, tiles.data(), tiles.size())) {
+    renderSystem->removeTexture(name);
+    _cache = 0;
+    return image;
+  }
+  _cacheImage = _image;
+  _cacheSize = size;
+  return _cache;
+}
+
+void Plane::update(uint64_t ticks) {
+  if (_lastTicks && ticks > _lastTicks) {
+    auto seconds = (ticks - _lastTicks) / 1000.f;
+    _origin.x += _velocity.x * seconds;
+    _origin.y += _velocity.y * seconds;
+  }
+  _lastTicks = ticks;
+}
+
+void Plane::draw(RenderSystem *renderSystem, const SDL_FPoint &camera) {
+  if (_image.empty() || _viewport.w <= 0 || _viewport.h <= 0 ||
+      _color.a == 0) {
+    return;
+  }
+  auto image = renderSystem->getTextureHandle(_image);
+  auto texture = renderSystem->getTexture(image);
+  if (!texture || texture->w <= 0 || texture->h <= 0) {
+    return;
+  }
+  auto handle = prepareCache(renderSystem, image, texture);
+  float width = handle == image ? texture->w : _cacheSize.x;
+  float height = handle == image ? texture->h : _cacheSize.y;
+  auto x = _origin.x + camera.x * _parallax.x;
+  auto y = _origin.y + camera.y * _parallax.y;
+  // the cache width is a multiple of the image width, so wrapping by the
+  // image keeps the pattern continuous
+  x -= std::floor(x / texture->w) * texture->w;
+  y -= std::floor(y / texture->h) * texture->h;
+  // float rounding can land exactly on the image size
+  if (x >= texture->w) {
+    x -= texture->w;
+  }
+  if (y >= texture->h) {
+    y -= texture->h;
+  }
+  _fragments.clear();
+  for (float top = 0; top < _viewport.h;) {
+    auto sourceY = top == 0 ? y : 0;
+    auto h = std::min(height - sourceY, _viewport.h - top);
+    if (h <= 0) {
+      break;
+    }
+    for (float left = 0; left < _viewport.w;) {
+      auto sourceX = left == 0 ? x : 0;
+      auto w = std::min(width - sourceX, _viewport.w - left);
+      if (w <= 0) {
+        break;
+      }
+      auto &fragment = _fragments.emplace_back();
+      fragment.setTexture(handle);
+      fragment.setLayer(_layer);
+      fragment.setZIndex(_zIndex);
+      fragment.setColor(_color);
+      fragment.setBlendMode(_blend);
+      fragment.setRect({_viewport.x + left, _viewport.y + top, w, h});
+      fragment.setClipRect({sourceX, sourceY, w, h});
+      left += w;
+    }
+    top += h;
+  }
+  renderSystem->draw(_fragments.data(), _fragments.size());
+}
+
+void Plane::release(RenderSystem *renderSystem) {
+  if (_cache) {
+    renderSystem->removeTexture(std::format("system.plane.{}", _id));
+    _cache = 0;
+    _cacheImage.clear();
+  }
+}
@@ -1,4 +1,6 @@
 #include "render/RenderSystem.hpp"
+#include "core/Profiler.hpp"
+#include "core/RadixSort.hpp"
 #include "render/Image.hpp"
 #include "runtime/Application.hpp"
 #include <SDL3/SDL.h>
@@ -7,73 +9,583 @@
 #include <SDL3/SDL_properties.h>
 #include <SDL3/SDL_render.h>
 #include <SDL3/SDL_surface.h>
+#include <algorithm>
+#include <cmath>
 #include <memory>
 RenderSystem::RenderSystem(SDL_Renderer *renderer) : _renderer(renderer) {
   SDL_SetRenderDrawColorFloat(_renderer, 0.2, 0.3, 0.3, 1.0);
+  getTextureHandle(MISSING_TEXTURE);
+  _animations.push_back({});
+  _subtract = SDL_ComposeCustomBlendMode(
+      SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE,
+      SDL_BLENDOPERATION_REV_SUBTRACT, SDL_BLENDFACTOR_ZERO,
+      SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+  _subtractPremultiplied = SDL_ComposeCustomBlendMode(
+      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE,
+      SDL_BLENDOPERATION_REV_SUBTRACT, SDL_BLENDFACTOR_ZERO,
+      SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+  // the first 32-bit byte-order format the renderer lists is the one it can
+  // take without converting, images are decoded straight into it
+  auto formats = static_cast<const SDL_PixelFormat *>(SDL_GetPointerProperty(
+      SDL_GetRendererProperties(_renderer),
+      SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, nullptr));
+  for (auto format = formats; format && *format != SDL_PIXELFORMAT_UNKNOWN;
+       ++format) {
+    if (*format == SDL_PIXELFORMAT_RGBA32 ||
+        *format == SDL_PIXELFORMAT_BGRA32) {
+      _textureFormat = *format;
+      break;
+    }
+  }
 }
 RenderSystem::~RenderSystem() {
   if (_renderer) {
-    for (auto &[_, texture] : _textures) {
-      SDL_DestroyTexture(texture);
+    for (auto texture :
+         {_scene, _frozen, _transitionTarget, _transitionMask}) {
+      if (texture) {
+        SDL_DestroyTexture(texture);
+      }
+    }
+    for (auto &entry : _textures) {
+      if (entry.texture) {
+        SDL_DestroyTexture(entry.texture);
+      }
     }
     _textures.clear();
+    _textureHandles.clear();
     SDL_DestroyRenderer(_renderer);
     _renderer = nullptr;
   }
 }
-void RenderSystem::draw(Fragment *fragment) {
-  _fragements[fragment->getZIndex()].push_back(fragment);
-  if (!_textures.contains(fragment->getTexture())) {
-    auto app = Application::getInstance();
-    auto asset = app->getAssetManager()->query(fragment->getTexture());
-    auto image = std::dynamic_pointer_cast<Image>(asset);
-    if (image) {
-      SDL_Texture *texture =
-          createTexture(fragment->getTexture(), image->getSurface());
-      if (!texture) {
-        _logger->error("Failed to create texture '{}': {}",
-                       fragment->getTexture(), SDL_GetError());
-        _textures[fragment->getTexture()] = _textures["system.texture.missing"];
-      } else {
-        _textures[fragment->getTexture()] = texture;
+// layer:8 | z:16 | batch:16 | sequence:24. z is clamped to the range
+// documented on Fragment; batch is a per-frame texture id from getBatch.
+uint64_t RenderSystem::makeSortKey(uint8_t layer, int32_t zIndex,
+                                   uint32_t batch, uint32_t sequence) {
+  auto z = static_cast<uint64_t>(
+      std::clamp(zIndex, Fragment::Z_MIN, Fragment::Z_MAX) - Fragment::Z_MIN);
+  return (static_cast<uint64_t>(layer) << 56) | (z << 40) |
+         (static_cast<uint64_t>(batch) << 24) | (sequence & 0xffffff);
+}
+uint32_t RenderSystem::getBatch(uint32_t texture) {
+  // Handles only grow, so they are renumbered in order of first use each
+  // frame. Past 65536 textures in one frame the rest share the last id,
+  // which only costs batching, never order.
+  if (texture >= _batches.size()) {
+    _batches.resize(_textures.size());
+  }
+  auto &batch = _batches[texture];
+  if (batch.frame != _frame) {
+    batch.frame = _frame;
+    batch.id = std::min(_batchCount++, 0xffffu);
+  }
+  return batch.id;
+}
+std::shared_ptr<Image>
+RenderSystem::findImage(const std::string &name) const {
+  auto assetManager = Application::getInstance()->getAssetManager();
+  if (!assetManager) {
+    return nullptr;
+  }
+  return std::dynamic_pointer_cast<Image>(assetManager->query(name));
+}
+SDL_Texture *RenderSystem::resolveTexture(uint32_t handle) {
+  auto &entry = _textures[handle];
+  if (!entry.resolved) {
+    entry.resolved = true;
+    auto image = findImage(entry.name);
+    if (image && image->getSurface()) {
+      auto name = entry.name;
+      createTexture(name, image->getSurface(), image->isPremultiplied());
+    }
+  }
+  return _textures[handle].texture;
+}
+void RenderSystem::requestTexture(uint32_t handle) {
+  auto &entry = _textures[handle];
+  if (entry.resolved || entry.queued) {
+    return;
+  }
+  auto image = findImage(entry.name);
+  if (!image) {
+    entry.resolved = true;
+    return;
+  }
+  entry.queued = true;
+  _uploads.push_back(handle);
+}
+void RenderSystem::processUploads() {
+  PROFILE_ZONE("RenderSystem::processUploads");
+  auto frequency = static_cast<float>(SDL_GetPerformanceFrequency());
+  auto start = SDL_GetPerformanceCounter();
+  size_t bytes = 0;
+  float elapsed = 0.f;
+  // decoding happens on the loader threads, only the upload itself is paid
+  // here and it is spread across frames once the budget is spent
+  for (size_t count = _uploads.size(); count > 0 && !_uploads.empty();
+       --count) {
+    if (bytes >= _uploadBudget || elapsed >= _uploadTime) {
+      break;
+    }
+    auto handle = _uploads.front();
+    _uploads.pop_front();
+    auto &entry = _textures[handle];
+    if (entry.resolved) {
+      entry.queued = false;
+      continue;
+    }
+    auto image = findImage(entry.name);
+    if (image && !image->isReady()) {
+      _uploads.push_back(handle);
+      continue;
+    }
+    entry.queued = false;
+    entry.resolved = true;
+    auto surface = image ? image->getSurface() : nullptr;
+    if (!surface) {
+      continue;
+    }
+    auto name = entry.name;
+    if (createTexture(name, surface, image->isPremultiplied())) {
+      bytes += static_cast<size_t>(surface->pitch) * surface->h;
+      _uploadStats.uploads++;
+    }
+    elapsed = (SDL_GetPerformanceCounter() - start) * 1000.f / frequency;
+  }
+  _uploadStats.bytes += bytes;
+  _uploadStats.pending = static_cast<uint32_t>(_uploads.size());
+  _uploadStats.lastTime = elapsed;
+  _uploadStats.maxTime = std::max(_uploadStats.maxTime, elapsed);
+  if (elapsed > _uploadTime * 2) {
+    _uploadStats.hitches++;
+    _logger->warn("Texture upload hitch: {:.2f}ms for {} bytes", elapsed,
+                  bytes);
+  }
+}
+void RenderSystem::updateAnimations() {
+  auto ticks = SDL_GetTicks();
+  _animationOffsets.resize(_animations.size());
+  for (size_t index = 0; index < _animations.size(); ++index) {
+    auto &animation = _animations[index];
+    uint32_t frame = 0;
+    if (animation.frames > 1 && animation.period) {
+      frame = (ticks % animation.period) * animation.frames / animation.period;
+    }
+    _animationOffsets[index] = {animation.stride.x * frame,
+                                animation.stride.y * frame};
+  }
+}
+SDL_Texture *RenderSystem::prepareTexture(const Fragment &fragment) {
+  auto *entry = &_textures[fragment.getTexture()];
+  if (!entry->texture) {
+    entry = &_textures[0];
+    if (!entry->texture) {
+      return nullptr;
+    }
+  }
+  auto color = fragment.getColor();
+  if (color.r != entry->color.r || color.g != entry->color.g ||
+      color.b != entry->color.b ||
+      (entry->premultiplied && color.a != entry->color.a)) {
+    if (entry->premultiplied) {
+      // premultiplied texels need the alpha mod applied to the colour too
+      SDL_SetTextureColorMod(entry->texture, color.r * color.a / 255,
+                             color.g * color.a / 255, color.b * color.a / 255);
+    } else {
+      SDL_SetTextureColorMod(entry->texture, color.r, color.g, color.b);
+    }
+  }
+  if (color.a != entry->color.a) {
+    SDL_SetTextureAlphaMod(entry->texture, color.a);
+  }
+  entry->color = color;
+  if (fragment.getBlendMode() != entry->blend) {
+    entry->blend = fragment.getBlendMode();
+    auto premultiplied = entry->premultiplied;
+    switch (entry->blend) {
+    case Fragment::Blend::ADD:
+      SDL_SetTextureBlendMode(entry->texture,
+                              premultiplied ? SDL_BLENDMODE_ADD_PREMULTIPLIED
+                                            : SDL_BLENDMODE_ADD);
+      break;
+    case Fragment::Blend::SUBTRACT:
+      if (SDL_SetTextureBlendMode(entry->texture, premultiplied
+                                                      ? _subtractPremultiplied
+                                                      : _subtract)) {
+        break;
       }
+      [[fallthrough]];
+    default:
+      SDL_SetTextureBlendMode(entry->texture,
+                              premultiplied ? SDL_BLENDMODE_BLEND_PREMULTIPLIED
+                                            : SDL_BLENDMODE_BLEND);
+      break;
+    }
+  }
+  return entry->texture;
+}
+void RenderSystem::draw(const Fragment &fragment) { draw(&fragment, 1); }
+void RenderSystem::draw(const Fragment *fragments, size_t count,
+                        const SDL_FPoint &offset) {
+  if (!count) {
+    return;
+  }
+  auto base = static_cast<uint32_t>(_fragments.size());
+  _fragments.resize(base + count);
+  memcpy(&_fragments[base], fragments, count * sizeof(Fragment));
+  bool translate = offset.x != 0.f || offset.y != 0.f;
+  uint32_t lastTexture = UINT32_MAX;
+  uint32_t batch = 0;
+  for (uint32_t index = base; index < base + count; ++index) {
+    auto &fragment = _fragments[index];
+    if (translate) {
+      auto &rect = fragment.getRect();
+      fragment.setPosition({rect.x + offset.x, rect.y + offset.y});
+    }
+    auto texture = fragment.getTexture();
+    if (texture >= _textures.size()) {
+      texture = 0;
+      fragment.setTexture(0);
+    }
+    if (fragment.getAnimation() >= _animations.size()) {
+      fragment.setAnimation(0);
+    }
+    if (texture != lastTexture) {
+      batch = getBatch(texture);
+      lastTexture = texture;
+    }
+    _drawList.push_back({makeSortKey(fragment.getLayer(), fragment.getZIndex(),
+                                     batch, index),
+                         index});
+  }
+}
+
+bool RenderSystem::prepareScene() {
+  int w = 0;
+  int h = 0;
+  if (!SDL_GetRenderOutputSize(_renderer, &w, &h) || w <= 0 || h <= 0) {
+    return false;
+  }
+  if (_scene && _scene->w == w && _scene->h == h) {
+    return true;
+  }
+  if (_scene) {
+    SDL_DestroyTexture(_scene);
+  }
+  _scene = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32,
+                             SDL_TEXTUREACCESS_TARGET, w, h);
+  if (!_scene) {
+    _logger->error("Failed to create scene target: {}", SDL_GetError());
+    return false;
+  }
+  SDL_SetTextureBlendMode(_scene, SDL_BLENDMODE_NONE);
+  return true;
+}
+
+SDL_Texture *RenderSystem::loadTransitionMask(const std::string &name) {
+  if (name == _transitionMaskName) {
+    return _transitionMask;
+  }
+  if (_transitionMask) {
+    SDL_DestroyTexture(_transitionMask);
+    _transitionMask = nullptr;
+  }
+  _transitionMaskName = name;
+  if (name.empty()) {
+    return nullptr;
+  }
+  auto asset = Application::getInstance()->getAssetManager()->query(name);
+  auto image = std::dynamic_pointer_cast<Image>(asset);
+  if (!image || !image->getSurface()) {
+    _logger->error("Failed to load transition mask '{}'", name);
+    return nullptr;
+  }
+  // the grey level becomes the alpha channel once per mask, every frame
+  // after that works on the GPU only
+  auto surface =
+      SDL_ConvertSurface(image->getSurface(), SDL_PIXELFORMAT_RGBA32);
+  if (!surface) {
+    _logger->error("Failed to convert transition mask '{}': {}", name,
+                   SDL_GetError());
+    return nullptr;
+  }
+  SDL_LockSurface(surface);
+  for (int y = 0; y < surface->h; ++y) {
+    auto row = static_cast<uint8_t *>(surface->pixels) + y * surface->pitch;
+    for (int x = 0; x < surface->w; ++x) {
+      auto pixel = row + x * 4;
+      pixel[3] = pixel[0];
+    }
+  }
+  SDL_UnlockSurface(surface);
+  _transitionMask = SDL_CreateTextureFromSurface(_renderer, surface);
+  SDL_DestroySurface(surface);
+  if (_transitionMask) {
+    SDL_SetTextureBlendMode(_transitionMask, SDL_BLENDMODE_NONE);
+  }
+  return _transitionMask;
+}
+
+bool RenderSystem::composeMask(float progress) {
+  auto mask = loadTransitionMask(_transitionMaskName);
+  if (!mask || !_maskSupported) {
+    return false;
+  }
+  auto w = _scene->w;
+  auto h = _scene->h;
+  if (!_transitionTarget || _transitionTarget->w != w ||
+      _transitionTarget->h != h) {
+    if (_transitionTarget) {
+      SDL_DestroyTexture(_transitionTarget);
     }
+    _transitionTarget = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32,
+                                          SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!_transitionTarget) {
+      return false;
+    }
+  }
+  // alpha = clamp((mask - threshold) * 2^passes): the threshold is applied
+  // with a subtractive fill and the slope with doubling fills
+  uint32_t passes = 0;
+  while (passes < 8 && (256u >> passes) > _transitionVague) {
+    passes++;
+  }
+  auto slope = static_cast<float>(1u << passes);
+  auto threshold = progress * (1.f + 1.f / slope) - 1.f / slope;
+  auto keepColor = [](SDL_BlendFactor src, SDL_BlendFactor dst,
+                      SDL_BlendOperation operation) {
+    return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE,
+                                      SDL_BLENDOPERATION_ADD, src, dst,
+                                      operation);
+  };
+  auto lower = keepColor(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE,
+                         threshold >= 0 ? SDL_BLENDOPERATION_REV_SUBTRACT
+                                        : SDL_BLENDOPERATION_ADD);
+  auto amplify = keepColor(SDL_BLENDFACTOR_DST_ALPHA, SDL_BLENDFACTOR_ONE,
+                           SDL_BLENDOPERATION_ADD);
+  auto apply = SDL_ComposeCustomBlendMode(
+      SDL_BLENDFACTOR_DST_ALPHA, SDL_BLENDFACTOR_ZERO, SDL_BLENDOPERATION_ADD,
+      SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+  float r, g, b, a;
+  SDL_GetRenderDrawColorFloat(_renderer, &r, &g, &b, &a);
+  SDL_SetRenderTarget(_renderer, _transitionTarget);
+  SDL_RenderTexture(_renderer, mask, nullptr, nullptr);
+  bool ok = SDL_SetRenderDrawBlendMode(_renderer, lower) &&
+            SDL_SetTextureBlendMode(_frozen, apply);
+  if (ok) {
+    SDL_SetRenderDrawColorFloat(_renderer, 0, 0, 0, std::fabs(threshold));
+    SDL_RenderFillRect(_renderer, nullptr);
+    SDL_SetRenderDrawBlendMode(_renderer, amplify);
+    SDL_SetRenderDrawColorFloat(_renderer, 0, 0, 0, 1);
+    for (uint32_t pass = 0; pass < passes; ++pass) {
+      SDL_RenderFillRect(_renderer, nullptr);
+    }
+    SDL_RenderTexture(_renderer, _frozen, nullptr, nullptr);
+  }
+  SDL_SetRenderDrawBlendMode(_renderer, SDL_BLENDMODE_NONE);
+  SDL_SetRenderDrawColorFloat(_renderer, r, g, b, a);
+  SDL_SetTextureBlendMode(_frozen, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderTarget(_renderer, nullptr);
+  if (!ok) {
+    _logger->warn("Custom blend modes unsupported, using crossfade: {}",
+                  SDL_GetError());
+    _maskSupported = false;
+    return false;
+  }
+  SDL_SetTextureBlendMode(_transitionTarget,
+                          SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+  SDL_RenderTexture(_renderer, _transitionTarget, nullptr, nullptr);
+  return true;
+}
+
+void RenderSystem::composeScreen() {
+  SDL_RenderTexture(_renderer, _scene, nullptr, nullptr);
+  if (!_frozenActive || !_frozen) {
+    return;
+  }
+  if (!_transitioning) {
+    SDL_SetTextureBlendMode(_frozen, SDL_BLENDMODE_NONE);
+    SDL_RenderTexture(_renderer, _frozen, nullptr, nullptr);
+    return;
+  }
+  auto elapsed = SDL_GetTicks() - _transitionStart;
+  if (elapsed >= _transitionDuration) {
+    _frozenActive = false;
+    _transitioning = false;
+    return;
+  }
+  auto progress = static_cast<float>(elapsed) / _transitionDuration;
+  if (!_transitionMaskName.empty() && composeMask(progress)) {
+    return;
+  }
+  SDL_SetTextureBlendMode(_frozen, SDL_BLENDMODE_BLEND);
+  SDL_SetTextureAlphaModFloat(_frozen, 1.f - progress);
+  SDL_RenderTexture(_renderer, _frozen, nullptr, nullptr);
+  SDL_SetTextureAlphaModFloat(_frozen, 1.f);
+}
+
+void RenderSystem::freeze() {
+  if (!_scene) {
+    return;
+  }
+  std::swap(_scene, _frozen);
+  _frozenActive = true;
+  _transitioning = false;
+}
+
+void RenderSystem::transition(uint32_t duration, const std::string &mask,
+                              uint32_t vague) {
+  if (!_frozenActive) {
+    return;
+  }
+  if (duration == 0) {
+    _frozenActive = false;
+    return;
   }
+  _transitioning = true;
+  _transitionStart = SDL_GetTicks();
+  _transitionDuration = duration;
+  _transitionVague = std::clamp(vague, 1u, 256u);
+  loadTransitionMask(mask);
 }
 
 void RenderSystem::present() {
   if (!_renderer) {
     return;
   }
+  PROFILE_ZONE("RenderSystem::present");
+  Profiler::counter("fragments", _fragments.size());
+  bool capture = prepareScene();
+  if (capture) {
+    SDL_SetRenderTarget(_renderer, _scene);
+  }
   SDL_RenderClear(_renderer);
-  for (auto &[_, fragments] : _fragements) {
-    for (auto &fragment : fragments) {
-      SDL_Texture *texture = nullptr;
-      auto &textureName = fragment->getTexture();
-      if (_textures.contains(textureName)) {
-        texture = _textures.at(textureName);
-      }
-      if (!texture) {
-        texture = _textures.at("system.texture.missing");
-      }
-      SDL_RenderTextureRotated(_renderer, texture, &fragment->getClipRect(),
-                               &fragment->getRect(), fragment->getRotateAngle(),
-                               &fragment->getRotateCenter(),
-                               fragment->getFlipMode());
+  processUploads();
+  Profiler::counter("uploads.pending", _uploads.size());
+  {
+    PROFILE_ZONE("RenderSystem::sort");
+    radixSort(_drawList, _sortBuffer,
+              [](const DrawItem &item) { return item.key; });
+  }
+  updateAnimations();
+  uint32_t lastTexture = UINT32_MAX;
+  for (auto &item : _drawList) {
+    auto &fragment = _fragments[item.fragment];
+    if (fragment.getTexture() != lastTexture) {
+      // textures start loading once drawn and show up a few frames later
+      lastTexture = fragment.getTexture();
+      requestTexture(lastTexture);
+    }
+    auto texture = prepareTexture(fragment);
+    if (fragment.getAnimation()) {
+      auto &offset = _animationOffsets[fragment.getAnimation()];
+      auto &clip = fragment.getClipRect();
+      fragment.setClipPosition({clip.x + offset.x, clip.y + offset.y});
     }
-    fragments.clear();
+    if (fragment.hasTransform()) {
+      SDL_RenderTextureRotated(_renderer, texture, &fragment.getClipRect(),
+                               &fragment.getRect(), fragment.getRotateAngle(),
+                               &fragment.getRotateCenter(),
+                               fragment.getFlipMode());
+    } else {
+      SDL_RenderTexture(_renderer, texture, &fragment.getClipRect(),
+                        &fragment.getRect());
+    }
+  }
+  _drawList.clear();
+  _fragments.clear();
+  _frame++;
+  _batchCount = 0;
+  _glyphAtlas->beginFrame();
+  if (capture) {
+    SDL_SetRenderTarget(_renderer, nullptr);
+    composeScreen();
   }
+  PROFILE_ZONE("SDL_RenderPresent");
   SDL_RenderPresent(_renderer);
 }
+bool RenderSystem::renderToTexture(uint32_t target, const Fragment *fragments,
+                                   size_t count, const SDL_FPoint &offset) {
+  auto texture = getTexture(target);
+  if (!_renderer || !texture) {
+    return false;
+  }
+  if (!SDL_SetRenderTarget(_renderer, texture)) {
+    _logger->error("Failed to set render target '{}': {}",
+                   _textures[target].name, SDL_GetError());
+    return false;
+  }
+  float r, g, b, a;
+  SDL_GetRenderDrawColorFloat(_renderer, &r, &g, &b, &a);
+  SDL_SetRenderDrawColorFloat(_renderer, 0, 0, 0, 0);
+  SDL_RenderClear(_renderer);
+  SDL_SetRenderDrawColorFloat(_renderer, r, g, b, a);
+  for (size_t index = 0; index < count; ++index) {
+    auto &fragment = fragments[index];
+    if (fragment.getTexture() >= _textures.size()) {
+      continue;
+    }
+    requestTexture(fragment.getTexture());
+    auto source = prepareTexture(fragment);
+    auto rect = fragment.getRect();
+    rect.x += offset.x;
+    rect.y += offset.y;
+    if (fragment.hasTransform()) {
+      SDL_RenderTextureRotated(_renderer, source, &fragment.getClipRect(),
+                               &rect, fragment.getRotateAngle(),
+                               &fragment.getRotateCenter(),
+                               fragment.getFlipMode());
+    } else {
+      SDL_RenderTexture(_renderer, source, &fragment.getClipRect(), &rect);
+    }
+  }
+  SDL_SetRenderTarget(_renderer, nullptr);
+  return true;
+}
+uint32_t RenderSystem::getTextureHandle(const std::string &name) {
+  auto it = _textureHandles.find(name);
+  if (it != _textureHandles.end()) {
+    return it->second;
+  }
+  auto handle = static_cast<uint32_t>(_textures.size());
+  _textures.push_back({name});
+  _textureHandles[name] = handle;
+  return handle;
+}
+uint16_t RenderSystem::createAnimation(uint32_t frames, uint32_t period,
+                                       const SDL_FPoint &stride) {
+  if (_animations.size() > UINT16_MAX) {
+    _logger->error("Too many animations");
+    return 0;
+  }
+  auto handle = static_cast<uint16_t>(_animations.size());
+  _animations.push_back({frames, period, stride});
+  return handle;
+}
+void RenderSystem::setAnimation(uint16_t handle, uint32_t frames,
+                                uint32_t period, const SDL_FPoint &stride) {
+  if (handle == 0 || handle >= _animations.size()) {
+    return;
+  }
+  _animations[handle] = {frames, period, stride};
+}
 SDL_Texture *RenderSystem::createTexture(const std::string &name,
-                                         SDL_Surface *surface) {
+                                         SDL_Surface *surface,
+                                         bool premultiplied) {
   removeTexture(name);
   SDL_Texture *tex = SDL_CreateTextureFromSurface(_renderer, surface);
   if (!tex) {
     _logger->error("Failed to create texture '{}': {}", name, SDL_GetError());
     return nullptr;
   }
-  _textures[name] = tex;
+  if (premultiplied) {
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+  }
+  auto &entry = _textures[getTextureHandle(name)];
+  entry.texture = tex;
+  entry.resolved = true;
+  entry.premultiplied = premultiplied;
+  entry.color = {255, 255, 255, 255};
+  entry.blend = Fragment::Blend::NORMAL;
   return tex;
 }
 SDL_Texture *RenderSystem::createTexture(const std::string &name, uint32_t w,
@@ -85,19 +597,37 @@ SDL_Texture *RenderSystem::createTexture(const std::string &name, uint32_t w,
     _logger->error("Failed to create texture '{}': {}", name, SDL_GetError());
     return nullptr;
   }
-  _textures[name] = tex;
+  auto &entry = _textures[getTextureHandle(name)];
+  entry.texture = tex;
+  entry.resolved = true;
+  entry.premultiplied = false;
+  entry.color = {255, 255, 255, 255};
+  entry.blend = Fragment::Blend::NORMAL;
   return tex;
 }
 
 SDL_Texture *RenderSystem::getTexture(const std::string &name) {
-  if (_textures.contains(name)) {
-    return _textures.at(name);
+  return getTexture(getTextureHandle(name));
+}
+SDL_Texture *RenderSystem::getTexture(uint32_t handle) {
+  if (handle >= _textures.size()) {
+    return nullptr;
   }
-  return nullptr;
+  requestTexture(handle);
+  return _textures[handle].texture;
+}
+SDL_Texture *RenderSystem::loadTexture(const std::string &name) {
+  return resolveTexture(getTextureHandle(name));
 }
 void RenderSystem::removeTexture(const std::string &name) {
-  if (_textures.contains(name)) {
-    SDL_DestroyTexture(_textures.at(name));
-    _textures.erase(name);
+  auto it = _textureHandles.find(name);
+  if (it == _textureHandles.end()) {
+    return;
+  }
+  auto &entry = _textures[it->second];
+  if (entry.texture) {
+    SDL_DestroyTexture(entry.texture);
+    entry.texture = nullptr;
   }
+  entry.resolved = false;
 }
\ No newline at end of file
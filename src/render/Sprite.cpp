@@ -3,10 +3,9 @@
 #include <SDL3/SDL.h>
 void Sprite::setImage(const std::string &name) {
   auto app = Application::getInstance();
-  if (_fragment.getTexture() != name) {
-    _fragment.setTexture(name);
+  if (_image != name) {
+    _image = name;
+    _fragment.setTexture(app->getRenderSystem()->getTextureHandle(name));
   }
 }
-void Sprite::draw(RenderSystem *renderSystem) {
-  renderSystem->draw(&_fragment);
-}
\ No newline at end of file
+void Sprite::draw(RenderSystem *renderSystem) { renderSystem->draw(_fragment); }
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "render/SpriteAnimator.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+SpriteAnimator::SpriteAnimator() {
+  // sheet 0 shows the whole texture, clock 0 never advances
+  _sheets.push_back({1, 1, 0, 0});
+  _clocks.push_back({1, 0});
+}
+
+uint16_t SpriteAnimator::createSheet(uint16_t columns, uint16_t rows,
+                                     float frameWidth, float frameHeight) {
+  if (_sheets.size() > UINT16_MAX) {
+    _logger->error("Too many sprite sheets");
+    return 0;
+  }
+  _sheets.push_back({std::max<uint16_t>(columns, 1),
+                     std::max<uint16_t>(rows, 1), frameWidth, frameHeight});
+  return static_cast<uint16_t>(_sheets.size() - 1);
+}
+
+uint16_t SpriteAnimator::createSheet(RenderSystem *renderSystem,
+                                     const std::string &texture,
+                                     uint16_t columns, uint16_t rows) {
+  // the frame size is needed right away, so this one loads synchronously
+  auto handle = renderSystem->loadTexture(texture);
+  if (!handle || !columns || !rows) {
+    _logger->error("Failed to create sprite sheet '{}'", texture);
+    return 0;
+  }
+  return createSheet(columns, rows, static_cast<float>(handle->w / columns),
+                     static_cast<float>(handle->h / rows));
+}
+
+uint16_t SpriteAnimator::createClock(uint32_t frames, uint32_t period) {
+  if (_clocks.size() > UINT16_MAX) {
+    _logger->error("Too many animation clocks");
+    return 0;
+  }
+  _clocks.push_back({frames, period});
+  return static_cast<uint16_t>(_clocks.size() - 1);
+}
+
+void SpriteAnimator::setClock(uint16_t clock, uint32_t frames,
+                              uint32_t period) {
+  if (clock == 0 || clock >= _clocks.size()) {
+    return;
+  }
+  _clocks[clock] = {frames, period};
+}
+
+uint32_t SpriteAnimator::add(Sprite *sprite, uint16_t sheet, uint16_t clock) {
+  if (sheet >= _sheets.size()) {
+    sheet = 0;
+  }
+  if (clock >= _clocks.size()) {
+    clock = 0;
+  }
+  uint32_t id;
+  if (!_freeIds.empty()) {
+    id = _freeIds.back();
+    _freeIds.pop_back();
+  } else {
+    id = _indices.size();
+    _indices.push_back(0);
+  }
+  _indices[id] = _sprites.size();
+  _sprites.push_back(sprite);
+  _spriteSheets.push_back(sheet);
+  _spriteClocks.push_back(clock);
+  _spriteRows.push_back(0);
+  _spritePhases.push_back(0);
+  _owners.push_back(id);
+  return id;
+}
+
+void SpriteAnimator::remove(uint32_t id) {
+  if (id >= _indices.size() || _indices[id] == UINT32_MAX) {
+    return;
+  }
+  auto index = _indices[id];
+  auto last = _sprites.size() - 1;
+  if (index != last) {
+    _sprites[index] = _sprites[last];
+    _spriteSheets[index] = _spriteSheets[last];
+    _spriteClocks[index] = _spriteClocks[last];
+    _spriteRows[index] = _spriteRows[last];
+    _spritePhases[index] = _spritePhases[last];
+    _owners[index] = _owners[last];
+    _indices[_owners[index]] = index;
+  }
+  _sprites.pop_back();
+  _spriteSheets.pop_back();
+  _spriteClocks.pop_back();
+  _spriteRows.pop_back();
+  _spritePhases.pop_back();
+  _owners.pop_back();
+  _indices[id] = UINT32_MAX;
+  _freeIds.push_back(id);
+}
+
+void SpriteAnimator::setSheet(uint32_t id, uint16_t sheet) {
+  if (id < _indices.size() && _indices[id] != UINT32_MAX &&
+      sheet < _sheets.size()) {
+    _spriteSheets[_indices[id]] = sheet;
+  }
+}
+
+void SpriteAnimator::setClock(uint32_t id, uint16_t clock) {
+  if (id < _indices.size() && _indices[id] != UINT32_MAX &&
+      clock < _clocks.size()) {
+    _spriteClocks[_indices[id]] = clock;
+  }
+}
+
+void SpriteAnimator::setRow(uint32_t id, uint16_t row) {
+  if (id < _indices.size() && _indices[id] != UINT32_MAX) {
+    _spriteRows[_indices[id]] = row;
+  }
+}
+
+void SpriteAnimator::setPhase(uint32_t id, uint16_t phase) {
+  if (id < _indices.size() && _indices[id] != UINT32_MAX) {
+    _spritePhases[_indices[id]] = phase;
+  }
+}
+
+void SpriteAnimator::update(uint64_t ticks) {
+  _clockFrames.resize(_clocks.size());
+  for (size_t index = 0; index < _clocks.size(); ++index) {
+    auto &clock = _clocks[index];
+    uint32_t frame = 0;
+    if (clock.frames > 1 && clock.period) {
+      frame = (ticks % clock.period) * clock.frames / clock.period;
+    }
+    _clockFrames[index] = frame;
+  }
+  auto sheets = _sheets.data();
+  auto frames = _clockFrames.data();
+  for (size_t index = 0; index < _sprites.size(); ++index) {
+    auto &sheet = sheets[_spriteSheets[index]];
+    if (!sheet.frameWidth) {
+      continue;
+    }
+    auto column =
+        (frames[_spriteClocks[index]] + _spritePhases[index]) % sheet.columns;
+    auto row = _spriteRows[index] % sheet.rows;
+    _sprites[index]->setClipRect({column * sheet.frameWidth,
+                                  row * sheet.frameHeight, sheet.frameWidth,
+                                  sheet.frameHeight});
+  }
+}
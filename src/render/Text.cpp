@@ -0,0 +1,119 @@
+#include "render/Text.hpp"
+#include "runtime/Application.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+void Text::setI18n(
+    const std::string &key,
+    const std::unordered_map<std::string, std::string> &options) {
+  setText(Application::getInstance()->getLocaleManager()->i18n(key, options));
+}
+
+void Text::setColor(const SDL_Color &color) {
+  if (color.r == _color.r && color.g == _color.g && color.b == _color.b &&
+      color.a == _color.a) {
+    return;
+  }
+  _color = color;
+  for (auto &fragment : _fragments) {
+    fragment.setColor(color);
+  }
+}
+
+void Text::setZIndex(int32_t zIndex) {
+  if (_zIndex == zIndex) {
+    return;
+  }
+  _zIndex = zIndex;
+  for (auto &fragment : _fragments) {
+    fragment.setZIndex(zIndex);
+  }
+}
+
+void Text::setLayer(uint8_t layer) {
+  if (_layer == layer) {
+    return;
+  }
+  _layer = layer;
+  for (auto &fragment : _fragments) {
+    fragment.setLayer(layer);
+  }
+}
+
+void Text::layout(RenderSystem *renderSystem, bool retry) {
+  auto atlas = renderSystem->getGlyphAtlas();
+  _fragments.clear();
+  _bounds = {};
+  _dirty = false;
+  _generation = atlas->getGeneration();
+  if (!_font && !_fontName.empty()) {
+    auto asset =
+        Application::getInstance()->getAssetManager()->query(_fontName);
+    _font = std::dynamic_pointer_cast<Font>(asset);
+    if (!_font) {
+      _logger->error("Failed to find font '{}'", _fontName);
+    }
+  }
+  auto font = _font ? _font->getFont(_size) : nullptr;
+  if (!font) {
+    return;
+  }
+  auto lineSkip = static_cast<float>(TTF_GetFontLineSkip(font));
+  auto height = static_cast<float>(TTF_GetFontHeight(font));
+  float x = 0.f;
+  float y = 0.f;
+  uint32_t previous = 0;
+  const char *cursor = _text.c_str();
+  size_t remaining = _text.size();
+  while (remaining) {
+    auto codepoint = SDL_StepUTF8(&cursor, &remaining);
+    if (codepoint == '\n') {
+      x = 0.f;
+      y += lineSkip;
+      previous = 0;
+      continue;
+    }
+    auto glyph = atlas->getGlyph(renderSystem, font, codepoint);
+    if (atlas->getGeneration() != _generation && retry) {
+      // the atlas was flushed while laying out, start again once
+      layout(renderSystem, false);
+      return;
+    }
+    if (previous) {
+      int kerning = 0;
+      if (TTF_GetGlyphKerning(font, previous, codepoint, &kerning)) {
+        x += kerning;
+      }
+    }
+    if (_width > 0 && x > 0 && x + glyph->advance > _width) {
+      x = 0.f;
+      y += lineSkip;
+    }
+    if (glyph->clipRect.w > 0) {
+      auto &fragment = _fragments.emplace_back();
+      fragment.setTexture(glyph->texture);
+      fragment.setClipRect(glyph->clipRect);
+      fragment.setRect({x, y, glyph->clipRect.w, glyph->clipRect.h});
+      fragment.setColor(_color);
+      fragment.setZIndex(_zIndex);
+      fragment.setLayer(_layer);
+    }
+    x += glyph->advance;
+    _bounds.x = std::max(_bounds.x, x);
+    previous = codepoint;
+  }
+  _bounds.y = y + height;
+}
+
+const SDL_FPoint &Text::getBounds(RenderSystem *renderSystem) {
+  if (_dirty || _generation != renderSystem->getGlyphAtlas()->getGeneration()) {
+    layout(renderSystem);
+  }
+  return _bounds;
+}
+
+void Text::draw(RenderSystem *renderSystem) {
+  if (_dirty || _generation != renderSystem->getGlyphAtlas()->getGeneration()) {
+    layout(renderSystem);
+  }
+  renderSystem->draw(_fragments.data(), _fragments.size(), _position);
+}
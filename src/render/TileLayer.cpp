@@ -0,0 +1,393 @@
+#include "render/TileLayer.hpp"
+#include "core/Profiler.hpp"
+#include <atomic>
+#include <cmath>
+#include <format>
+static constexpr int32_t NEIGHBORS[8][2] = {
+    {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1},
+};
+
+TileLayer::TileLayer() {
+  static std::atomic<uint32_t> id = 0;
+  _id = id++;
+}
+
+uint64_t TileLayer::makeChunkKey(int32_t cx, int32_t cy) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+         static_cast<uint32_t>(cy);
+}
+
+uint8_t TileLayer::computeVariant(int32_t x, int32_t y, uint32_t tile) const {
+  uint8_t mask = 0;
+  for (uint32_t i = 0; i < 8; ++i) {
+    auto nx = x + NEIGHBORS[i][0];
+    auto ny = y + NEIGHBORS[i][1];
+    if (!contains(nx, ny) || _world->getTile(nx, ny) == tile) {
+      mask |= 1 << i;
+    }
+  }
+  return Autotile::getVariant(mask);
+}
+
+void TileLayer::computeVariants(VariantCache &cache, const TileChunk &chunk,
+                              int32_t cx, int32_t cy) {
+  cache.revision = chunk.getRevision();
+  cache.variants.assign(TileChunk::AREA, 0);
+  int32_t originX = cx * TileChunk::SIZE;
+  int32_t originY = cy * TileChunk::SIZE;
+  for (uint32_t y = 0; y < TileChunk::SIZE; ++y) {
+    for (uint32_t x = 0; x < TileChunk::SIZE; ++x) {
+      auto tile = chunk.getTile(x, y);
+      if (tile != 0) {
+        cache.variants[y * TileChunk::SIZE + x] =
+            computeVariant(originX + x, originY + y, tile);
+      }
+    }
+  }
+  // border cells of the neighbouring chunks may have been computed while
+  // this chunk was not resident yet
+  int32_t size = TileChunk::SIZE;
+  for (int32_t i = -1; i <= size; ++i) {
+    refreshVariant(originX + i, originY - 1);
+    refreshVariant(originX + i, originY + size);
+  }
+  for (int32_t i = 0; i < size; ++i) {
+    refreshVariant(originX - 1, originY + i);
+    refreshVariant(originX + size, originY + i);
+  }
+}
+
+void TileLayer::refreshVariant(int32_t x, int32_t y) {
+  auto cx = TileWorld::floorDiv(x, TileChunk::SIZE);
+  auto cy = TileWorld::floorDiv(y, TileChunk::SIZE);
+  auto key = makeChunkKey(cx, cy);
+  auto it = _variants.find(key);
+  if (it == _variants.end()) {
+    return;
+  }
+  auto chunk = _world->getChunk(cx, cy);
+  if (!chunk || chunk->getRevision() != it->second.revision) {
+    return;
+  }
+  uint32_t lx = x - cx * TileChunk::SIZE;
+  uint32_t ly = y - cy * TileChunk::SIZE;
+  auto tile = chunk->getTile(lx, ly);
+  auto variant = tile ? computeVariant(x, y, tile) : 0;
+  auto &slot = it->second.variants[ly * TileChunk::SIZE + lx];
+  if (slot == variant) {
+    return;
+  }
+  slot = variant;
+  auto cache = _chunks.find(key);
+  if (cache != _chunks.end()) {
+    cache->second.revision = 0;
+  }
+}
+
+void TileLayer::setTile(int32_t x, int32_t y, uint32_t tile) {
+  if (!contains(x, y)) {
+    return;
+  }
+  if (!_autotile) {
+    _world->setTile(x, y, tile);
+    return;
+  }
+  auto cx = TileWorld::floorDiv(x, TileChunk::SIZE);
+  auto cy = TileWorld::floorDiv(y, TileChunk::SIZE);
+  auto chunk = _world->getChunk(cx, cy);
+  auto revision = chunk ? chunk->getRevision() : 0;
+  _world->setTile(x, y, tile);
+  chunk = _world->getChunk(cx, cy);
+  if (chunk->getRevision() == revision) {
+    return;
+  }
+  auto it = _variants.find(makeChunkKey(cx, cy));
+  if (it != _variants.end() && it->second.revision == revision) {
+    it->second.revision = chunk->getRevision();
+  }
+  for (int32_t dy = -1; dy <= 1; ++dy) {
+    for (int32_t dx = -1; dx <= 1; ++dx) {
+      refreshVariant(x + dx, y + dy);
+    }
+  }
+}
+
+void TileLayer::setAnimatedTile(uint32_t tile, uint32_t frames,
+                              uint32_t period) {
+  auto &animated = _animatedTiles[tile];
+  animated.frames = frames;
+  animated.period = period;
+  _animationDirty = true;
+  _dirty = true;
+}
+
+void TileLayer::removeAnimatedTile(uint32_t tile) {
+  auto it = _animatedTiles.find(tile);
+  if (it == _animatedTiles.end()) {
+    return;
+  }
+  // the handle stays reserved so a later definition can reuse it
+  it->second.frames = 1;
+  it->second.period = 0;
+  _animationDirty = true;
+  _dirty = true;
+}
+
+void TileLayer::updateAnimations(RenderSystem *renderSystem) {
+  SDL_FPoint stride = {static_cast<float>(_tileSize.first), 0};
+  for (auto &[_, animated] : _animatedTiles) {
+    if (animated.animation) {
+      renderSystem->setAnimation(animated.animation, animated.frames,
+                                 animated.period, stride);
+    } else if (animated.frames > 1) {
+      animated.animation = renderSystem->createAnimation(
+          animated.frames, animated.period, stride);
+    }
+  }
+  _animationDirty = false;
+}
+
+Fragment &TileLayer::emitTile(ChunkCache &cache, int32_t x, int32_t y,
+                              uint32_t tile, uint32_t texture) {
+  auto &fragment = cache.fragments.emplace_back();
+  fragment.setTexture(texture);
+  fragment.setLayer(_layer);
+  fragment.setZIndex(_zIndex + getPriority(tile));
+  fragment.setRect({
+      static_cast<float>(x) * _tileSize.first,
+      static_cast<float>(y) * _tileSize.second,
+      static_cast<float>(_tileSize.first),
+      static_cast<float>(_tileSize.second),
+  });
+  return fragment;
+}
+
+void TileLayer::buildChunk(ChunkCache &cache, const TileChunk &chunk,
+                           int32_t cx, int32_t cy, uint32_t texture,
+                           const SDL_Texture *atlas) {
+  cache.fragments.clear();
+  cache.revision = chunk.getRevision();
+  if (_autotile) {
+    buildAutotileChunk(cache, chunk, cx, cy, texture);
+    return;
+  }
+  auto [width, height] = _tileSize;
+  auto tileWidth = atlas->w / width;
+  auto tileHeight = atlas->h / height;
+  if (tileWidth == 0) {
+    tileWidth = 1;
+    width = atlas->w;
+  }
+  if (tileHeight == 0) {
+    tileHeight = 1;
+    height = atlas->h;
+  }
+  for (uint32_t y = 0; y < TileChunk::SIZE; ++y) {
+    for (uint32_t x = 0; x < TileChunk::SIZE; ++x) {
+      auto tile = chunk.getTile(x, y);
+      if (tile == 0) {
+        continue;
+      }
+      int32_t worldX = cx * TileChunk::SIZE + x;
+      int32_t worldY = cy * TileChunk::SIZE + y;
+      if (!contains(worldX, worldY)) {
+        continue;
+      }
+      auto tileX = (tile - 1) % tileWidth;
+      auto tileY = (tile - 1) / tileWidth;
+      auto &fragment = emitTile(cache, worldX, worldY, tile, texture);
+      if (!_animatedTiles.empty()) {
+        auto animated = _animatedTiles.find(tile);
+        if (animated != _animatedTiles.end() && animated->second.frames > 1) {
+          fragment.setAnimation(animated->second.animation);
+        }
+      }
+      fragment.setClipRect({
+          static_cast<float>(tileX * width),
+          static_cast<float>(tileY * height),
+          static_cast<float>(width),
+          static_cast<float>(height),
+      });
+    }
+  }
+}
+
+void TileLayer::buildAutotileChunk(ChunkCache &cache, const TileChunk &chunk,
+                                   int32_t cx, int32_t cy, uint32_t texture) {
+  auto &variants = _variants[makeChunkKey(cx, cy)];
+  if (variants.revision != chunk.getRevision()) {
+    computeVariants(variants, chunk, cx, cy);
+  }
+  auto kinds = _autotile->getKindCount();
+  for (uint32_t y = 0; y < TileChunk::SIZE; ++y) {
+    for (uint32_t x = 0; x < TileChunk::SIZE; ++x) {
+      auto tile = chunk.getTile(x, y);
+      if (tile == 0 || tile > kinds) {
+        continue;
+      }
+      int32_t worldX = cx * TileChunk::SIZE + x;
+      int32_t worldY = cy * TileChunk::SIZE + y;
+      if (!contains(worldX, worldY)) {
+        continue;
+      }
+      auto &fragment = emitTile(cache, worldX, worldY, tile, texture);
+      fragment.setAnimation(_autotile->getAnimation(tile - 1));
+      fragment.setClipRect(_autotile->getClipRect(
+          tile - 1, variants.variants[y * TileChunk::SIZE + x]));
+    }
+  }
+}
+
+void TileLayer::bakeChunk(RenderSystem *renderSystem, ChunkCache &cache,
+                          int32_t cx, int32_t cy) {
+  // animated and raised tiles stay live, everything else is rendered once
+  // into a chunk sized target
+  std::vector<Fragment> flat;
+  std::vector<Fragment> live;
+  for (auto &fragment : cache.fragments) {
+    if (fragment.getAnimation() || fragment.getZIndex() != _zIndex) {
+      live.push_back(fragment);
+    } else {
+      flat.push_back(fragment);
+    }
+  }
+  if (flat.size() < 2) {
+    releaseBake(cache);
+    return;
+  }
+  auto pixelWidth = TileChunk::SIZE * _tileSize.first;
+  auto pixelHeight = TileChunk::SIZE * _tileSize.second;
+  auto width = static_cast<float>(pixelWidth);
+  auto height = static_cast<float>(pixelHeight);
+  if (cache.bake < 0) {
+    if (!_freeBakes.empty()) {
+      cache.bake = _freeBakes.back();
+      _freeBakes.pop_back();
+    } else {
+      auto name = std::format("system.tilelayer.{}.{}", _id, _bakes.size());
+      auto texture = renderSystem->createTexture(
+          name, pixelWidth, pixelHeight, SDL_PIXELFORMAT_RGBA32,
+          SDL_TEXTUREACCESS_TARGET);
+      if (!texture) {
+        return;
+      }
+      SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+      cache.bake = _bakes.size();
+      _bakes.push_back(renderSystem->getTextureHandle(name));
+    }
+  }
+  auto handle = _bakes[cache.bake];
+  float x = cx * width;
+  float y = cy * height;
+  if (!renderSystem->renderToTexture(handle, flat.data(), flat.size(),
+                                     {-x, -y})) {
+    releaseBake(cache);
+    return;
+  }
+  Fragment fragment;
+  fragment.setTexture(handle);
+  fragment.setLayer(_layer);
+  fragment.setZIndex(_zIndex);
+  fragment.setRect({x, y, width, height});
+  fragment.setClipRect({0, 0, width, height});
+  cache.fragments.swap(live);
+  cache.fragments.insert(cache.fragments.begin(), fragment);
+}
+
+void TileLayer::releaseBake(ChunkCache &cache) {
+  if (cache.bake >= 0) {
+    _freeBakes.push_back(cache.bake);
+    cache.bake = -1;
+  }
+}
+
+void TileLayer::draw(RenderSystem *renderSystem) {
+  PROFILE_ZONE("TileLayer::draw");
+  auto handle = renderSystem->getTextureHandle(
+      _autotile ? _autotile->getTexture() : _texture);
+  auto texture = renderSystem->getTexture(handle);
+  if (!texture) {
+    texture = renderSystem->getTexture(RenderSystem::MISSING_TEXTURE);
+  }
+  if (_textureReady != renderSystem->isTextureReady(handle)) {
+    _textureReady = !_textureReady;
+    _dirty = true;
+  }
+  if (_dirty) {
+    for (auto &[_, cache] : _chunks) {
+      releaseBake(cache);
+    }
+    _chunks.clear();
+    _variants.clear();
+    _dirty = false;
+  }
+  if (!_tileSize.first || !_tileSize.second) {
+    return;
+  }
+  auto view = _viewport;
+  if (view.w <= 0 || view.h <= 0) {
+    if (!isBounded()) {
+      return;
+    }
+    view = {0, 0, static_cast<float>(_size.first * _tileSize.first),
+            static_cast<float>(_size.second * _tileSize.second)};
+  }
+  auto left = static_cast<int32_t>(std::floor(view.x / _tileSize.first));
+  auto top = static_cast<int32_t>(std::floor(view.y / _tileSize.second));
+  auto right =
+      static_cast<int32_t>(std::ceil((view.x + view.w) / _tileSize.first));
+  auto bottom =
+      static_cast<int32_t>(std::ceil((view.y + view.h) / _tileSize.second));
+  _world->update(left, top, right - left, bottom - top);
+
+  if (_animationDirty) {
+    updateAnimations(renderSystem);
+  }
+  _frame++;
+  auto chunkLeft = TileWorld::floorDiv(left, TileChunk::SIZE);
+  auto chunkTop = TileWorld::floorDiv(top, TileChunk::SIZE);
+  auto chunkRight = TileWorld::floorDiv(right - 1, TileChunk::SIZE);
+  auto chunkBottom = TileWorld::floorDiv(bottom - 1, TileChunk::SIZE);
+  for (auto cy = chunkTop; cy <= chunkBottom; ++cy) {
+    for (auto cx = chunkLeft; cx <= chunkRight; ++cx) {
+      auto chunk = _world->getChunk(cx, cy);
+      if (!chunk || chunk->isEmpty()) {
+        continue;
+      }
+      auto key = makeChunkKey(cx, cy);
+      auto &cache = _chunks[key];
+      if (cache.revision != chunk->getRevision()) {
+        buildChunk(cache, *chunk, cx, cy, handle, texture);
+        if (_static) {
+          bakeChunk(renderSystem, cache, cx, cy);
+        } else {
+          releaseBake(cache);
+        }
+      }
+      cache.lastUsed = _frame;
+      renderSystem->draw(cache.fragments.data(), cache.fragments.size(),
+                         {-view.x, -view.y});
+    }
+  }
+  for (auto it = _chunks.begin(); it != _chunks.end();) {
+    if (it->second.lastUsed == _frame) {
+      ++it;
+      continue;
+    }
+    releaseBake(it->second);
+    it = _chunks.erase(it);
+  }
+  std::erase_if(_variants, [this](const auto &item) {
+    return !_chunks.contains(item.first);
+  });
+}
+
+void TileLayer::release(RenderSystem *renderSystem) {
+  for (size_t index = 0; index < _bakes.size(); ++index) {
+    renderSystem->removeTexture(
+        std::format("system.tilelayer.{}.{}", _id, index));
+  }
+  _bakes.clear();
+  _freeBakes.clear();
+  _dirty = true;
+}
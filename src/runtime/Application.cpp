@@ -1,7 +1,9 @@
 #include "runtime/Application.hpp"
+#include "core/Profiler.hpp"
 #include "core/ScopeGuard.hpp"
 #include "render/RenderSystem.hpp"
 #include "runtime/AssetManager.hpp"
+#include "runtime/FontLoader.hpp"
 #include "runtime/ImageLoader.hpp"
 #include "runtime/JsonLoader.hpp"
 #include "runtime/LocaleManager.hpp"
@@ -71,6 +73,7 @@ bool Application::createWindow() {
 bool Application::initAssetManager() {
   try {
     auto imgLoader = std::make_shared<ImageLoader>();
+    imgLoader->setFormat(_renderSystem->getTextureFormat());
     _assetManager.reset(new AssetManager());
     _assetManager->registerLoader("png", imgLoader);
     _assetManager->registerLoader("bmp", imgLoader);
@@ -78,6 +81,9 @@ bool Application::initAssetManager() {
     _assetManager->registerLoader("jpg", imgLoader);
     auto jsonLoader = std::make_shared<JsonLoader>();
     _assetManager->registerLoader("json", jsonLoader);
+    auto fontLoader = std::make_shared<FontLoader>();
+    _assetManager->registerLoader("ttf", fontLoader);
+    _assetManager->registerLoader("otf", fontLoader);
     if (!_assetManager->initStore(_cwd + "assets")) {
       _logger->error("Failed to load asset store: {}assets", _cwd);
     }
@@ -124,7 +130,7 @@ bool Application::initRenderSystem() {
                    SDL_GetRendererName(renderer));
     _renderSystem.reset(new RenderSystem(renderer));
     SDL_Texture *texture =
-        _renderSystem->createTexture("system.texture.missing", 2, 2);
+        _renderSystem->createTexture(RenderSystem::MISSING_TEXTURE, 2, 2);
     if (!texture) {
       return false;
     }
@@ -165,8 +171,34 @@ bool Application::initModManager() {
   }
   return false;
 }
+bool Application::initUIManager() {
+  try {
+    _uiManager.reset(new UIManager());
+    int width = 0;
+    int height = 0;
+    SDL_GetWindowSize(_window, &width, &height);
+    _uiManager->resize(width, height);
+    return true;
+  } catch (std::exception &e) {
+    _logger->error("Failed to create ui manager: {}", e.what());
+  } catch (...) {
+    _logger->error("Failed to create ui manager: unknown exception");
+  }
+  return false;
+}
 
 void Application::cleanup() {
+  auto &profile = getOption("profile");
+  if (!profile.empty()) {
+    Profiler::stop();
+    auto path = profile == "true" ? _cwd + "profile.json" : profile;
+    if (Profiler::exportTrace(path)) {
+      _logger->info("Profile written to '{}'", path);
+    } else {
+      _logger->error("Failed to write profile '{}'", path);
+    }
+  }
+  _uiManager.reset(nullptr);
   if (_renderSystem) {
     _renderSystem.reset(nullptr);
   }
@@ -174,6 +206,7 @@ void Application::cleanup() {
     SDL_DestroyWindow(_window);
     _window = nullptr;
   }
+  _assetManager.reset(nullptr);
   TTF_Quit();
   _logger->debug("Application cleaned up");
   SDL_Quit();
@@ -182,12 +215,18 @@ void Application::onWindowClose(const SDL_WindowEvent &event) {
   _logger->debug("Window close requested, exiting loop");
   _running = false;
 }
-void Application::onWindowResize(const SDL_WindowEvent &event) {}
+void Application::onWindowResize(const SDL_WindowEvent &event) {
+  _uiManager->resize(event.data1, event.data2);
+}
 void Application::onWindowFocusGained(const SDL_WindowEvent &event) {}
 void Application::onWindowFocusLost(const SDL_WindowEvent &event) {}
-void Application::onMouseButtonDown(const SDL_MouseButtonEvent &event) {}
+void Application::onMouseButtonDown(const SDL_MouseButtonEvent &event) {
+  _uiManager->onMouseButtonDown(event);
+}
 void Application::onMouseButtonUp(const SDL_MouseButtonEvent &event) {}
-void Application::onKeyDown(const SDL_KeyboardEvent &event) {}
+void Application::onKeyDown(const SDL_KeyboardEvent &event) {
+  _uiManager->onKeyDown(event);
+}
 void Application::onKeyUp(const SDL_KeyboardEvent &event) {}
 
 bool Application::processEvent() {
@@ -245,7 +284,10 @@ void Application::onInitialize() {
 }
 void Application::onPostInitialize() {}
 void Application::onUpdate() {
+  PROFILE_ZONE("Application::onUpdate");
   if (!processEvent()) {
+    _uiManager->update(SDL_GetTicks());
+    _uiManager->draw(_renderSystem.get());
     _renderSystem->present();
   }
 }
@@ -270,6 +312,10 @@ void Application::exit() {
 int Application::run(int argc, char **argv) {
   DEFER([this] { cleanup(); });
   resolveOptions(argc, argv);
+  if (!getOption("profile").empty()) {
+    Profiler::setThreadName("Main");
+    Profiler::start();
+  }
   if (!SDL_Init(SDL_INIT_VIDEO)) {
     SDL_Log("Could not initialize SDL: %s", SDL_GetError());
     return -1;
@@ -295,21 +341,24 @@ int Application::run(int argc, char **argv) {
   if (!initSaveManager()) {
     return -1;
   }
-  if (!initAssetManager()) {
-    return -1;
-  }
   if (!createWindow()) {
     return -1;
   }
   if (!initRenderSystem()) {
     return -1;
   }
+  if (!initAssetManager()) {
+    return -1;
+  }
   if (!initLocaleManager()) {
     return -1;
   }
   if (!initModManager()) {
     return -1;
   }
+  if (!initUIManager()) {
+    return -1;
+  }
   onPreInitialize();
   onInitialize();
   onPostInitialize();
@@ -1,6 +1,7 @@
 #include "runtime/AssetManager.hpp"
 #include "core/Buffer.hpp"
 #include "core/Object.hpp"
+#include "core/Profiler.hpp"
 #include <SDL3/SDL_iostream.h>
 #include <SDL3/SDL_log.h>
 #include <filesystem>
@@ -24,6 +25,7 @@ bool AssetManager::resolve(const std::string &source, Identity &output) {
   return true;
 }
 bool AssetManager::initStore(const std::string &path) {
+  PROFILE_ZONE("AssetManager::initStore");
   if (!std::filesystem::is_directory(path)) {
     _logger->error("Failed to init asset store: {}", path);
     return false;
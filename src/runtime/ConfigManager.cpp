@@ -4,6 +4,7 @@
 #include "runtime/Application.hpp"
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_iostream.h>
+#include <algorithm>
 #include <filesystem>
 #include <sstream>
 #include <toml++/toml.hpp>
@@ -13,6 +14,15 @@ ConfigManager::ConfigManager() {
   if (!std::filesystem::exists(_configPath)) {
     std::filesystem::create_directory(_configPath);
   }
+  _writer = std::thread(&ConfigManager::run, this);
+}
+ConfigManager::~ConfigManager() {
+  {
+    std::unique_lock lock(_mutex);
+    _stopping = true;
+  }
+  _wake.notify_one();
+  _writer.join();
 }
 static void resolveToml(Variable &variable, toml::node &node) {
   if (node.is_string()) {
@@ -119,7 +129,7 @@ void ConfigManager::loadConfig(const std::string &ns, const std::string &name) {
   buffer.reset(size);
   SDL_ReadIO(file, buffer.getData(), size);
   SDL_CloseIO(file);
-  std::string content((const char *)buffer.getData(), size);
+  std::string_view content((const char *)buffer.getData(), size);
   try {
     auto config = toml::parse(content, path);
     resolveToml(variable, config);
@@ -143,21 +153,181 @@ Variable &ConfigManager::getConfig(const std::string &ns,
   return _configs[ns][name];
 }
 
-void ConfigManager::saveConfig(const std::string &ns, const std::string &name) {
+bool ConfigManager::writeFile(const std::string &path,
+                              const Variable &config) {
+  std::string str = writeToml(config);
+  auto temp = path + ".tmp";
+  auto file = SDL_IOFromFile(temp.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+  bool ok = SDL_WriteIO(file, str.c_str(), str.length()) == str.length();
+  if (!SDL_CloseIO(file) || !ok) {
+    std::filesystem::remove(temp);
+    return false;
+  }
+  std::error_code error;
+  std::filesystem::rename(temp, path, error);
+  if (error) {
+    SDL_SetError("%s", error.message().c_str());
+    return false;
+  }
+  return true;
+}
+
+void ConfigManager::run() {
+  std::unique_lock lock(_mutex);
+  for (;;) {
+    auto now = std::chrono::steady_clock::now();
+    auto next = std::chrono::steady_clock::time_point::max();
+    std::vector<std::pair<std::string, Variable>> due;
+    for (auto it = _pending.begin(); it != _pending.end();) {
+      if (_stopping || it->second.deadline <= now) {
+        due.push_back({it->first, std::move(it->second.config)});
+        it = _pending.erase(it);
+      } else {
+        next = std::min(next, it->second.deadline);
+        ++it;
+      }
+    }
+    if (!due.empty()) {
+      _writing = true;
+      lock.unlock();
+      for (auto &[path, config] : due) {
+        if (!writeFile(path, config)) {
+          _logger->error("Failed to save config '{}': {}", path,
+                         SDL_GetError());
+        }
+      }
+      lock.lock();
+      _writing = false;
+      _idle.notify_all();
+      continue;
+    }
+    if (_stopping) {
+      return;
+    }
+    if (next == std::chrono::steady_clock::time_point::max()) {
+      _wake.wait(lock);
+    } else {
+      _wake.wait_until(lock, next);
+    }
+  }
+}
+
+void ConfigManager::schedule(const std::string &ns, const std::string &name) {
   std::string nsPath = _configPath + ns + "/";
   std::string path = nsPath + name + ".toml";
   if (!std::filesystem::exists(nsPath)) {
     std::filesystem::create_directory(nsPath);
   }
-  auto file = SDL_IOFromFile(path.c_str(), "w");
-  if (!file) {
-    _logger->error("Failed to save config '{}.{}': {}", ns, name,
-                   SDL_GetError());
-    return;
+  auto &config = getConfig(ns, name);
+  {
+    std::unique_lock lock(_mutex);
+    // later saves within the window replace the content but keep the
+    // deadline, so a config changed every frame is still written
+    auto [it, inserted] = _pending.try_emplace(path);
+    it->second.config = config;
+    if (inserted) {
+      it->second.deadline = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(SAVE_DELAY);
+    }
+  }
+  _wake.notify_one();
+}
+
+void ConfigManager::saveConfig(const std::string &ns, const std::string &name) {
+  schedule(ns, name);
+  notify(ns, name, "", getConfig(ns, name));
+}
+
+void ConfigManager::flush() {
+  std::unique_lock lock(_mutex);
+  auto now = std::chrono::steady_clock::now();
+  for (auto &[_, pending] : _pending) {
+    pending.deadline = now;
   }
-  if (_configs.contains(ns) && _configs[ns].contains(name)) {
-    std::string str = writeToml(_configs[ns][name]);
-    SDL_WriteIO(file, str.c_str(), str.length());
+  _wake.notify_one();
+  _idle.wait(lock, [this] { return _pending.empty() && !_writing; });
+}
+
+Variable *ConfigManager::findValue(Variable &config, const std::string &key,
+                                   bool create) {
+  if (key.empty()) {
+    return &config;
   }
-  SDL_CloseIO(file);
+  auto value = &config;
+  size_t start = 0;
+  while (start <= key.size()) {
+    auto end = std::min(key.find('.', start), key.size());
+    auto field = key.substr(start, end - start);
+    if (create && value->getType() != Variable::Type::OBJECT) {
+      value->setObject();
+    }
+    auto object = value->getObject();
+    if (!object) {
+      return nullptr;
+    }
+    auto it = object->find(field);
+    if (it == object->end()) {
+      if (!create) {
+        return nullptr;
+      }
+      it = object->try_emplace(field).first;
+    }
+    value = &it->second;
+    start = end + 1;
+  }
+  return value;
+}
+
+const Variable *ConfigManager::getValue(const std::string &ns,
+                                        const std::string &name,
+                                        const std::string &key) {
+  return findValue(getConfig(ns, name), key, false);
+}
+
+void ConfigManager::setValue(const std::string &ns, const std::string &name,
+                             const std::string &key, const Variable &value) {
+  auto &entry = *findValue(getConfig(ns, name), key, true);
+  entry = value;
+  schedule(ns, name);
+  notify(ns, name, key, entry);
+}
+
+void ConfigManager::addBinding(const std::shared_ptr<Binding> &binding) {
+  std::erase_if(_bindings, [](auto &item) { return item.expired(); });
+  binding->update(getValue(binding->ns, binding->name, binding->key));
+  _bindings.push_back(binding);
+}
+
+void ConfigManager::notify(const std::string &ns, const std::string &name,
+                           const std::string &key, const Variable &value) {
+  std::erase_if(_bindings, [](auto &item) { return item.expired(); });
+  auto &config = getConfig(ns, name);
+  for (auto &item : _bindings) {
+    auto binding = item.lock();
+    if (binding->ns == ns && binding->name == name) {
+      binding->update(findValue(config, binding->key, false));
+    }
+  }
+  // listeners may subscribe or unsubscribe while being called
+  auto subscriptions = _subscriptions;
+  for (auto &subscription : subscriptions) {
+    if (subscription.ns == ns && subscription.name == name) {
+      subscription.listener(key, value);
+    }
+  }
+}
+
+uint64_t ConfigManager::subscribe(const std::string &ns,
+                                  const std::string &name, Listener listener) {
+  auto id = _nextSubscription++;
+  _subscriptions.push_back({id, ns, name, std::move(listener)});
+  return id;
+}
+
+void ConfigManager::unsubscribe(uint64_t id) {
+  std::erase_if(_subscriptions,
+                [id](auto &subscription) { return subscription.id == id; });
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "runtime/FontLoader.hpp"
+#include "render/Font.hpp"
+#include <SDL3/SDL_iostream.h>
+#include <memory>
+std::shared_ptr<Object> FontLoader::load(const std::string &path) {
+  SDL_IOStream *file = SDL_IOFromFile(path.c_str(), "rb");
+  if (!file) {
+    _logger->error("Failed to open font file: {}", SDL_GetError());
+    return nullptr;
+  }
+  auto font = std::make_shared<Font>();
+  size_t size = SDL_GetIOSize(file);
+  font->getData().reset(size);
+  if (SDL_ReadIO(file, font->getData().getData(), size) != size) {
+    _logger->error("Failed to read font file: {}", SDL_GetError());
+    SDL_CloseIO(file);
+    return nullptr;
+  }
+  SDL_CloseIO(file);
+  return font;
+}
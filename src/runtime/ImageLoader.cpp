@@ -1,13 +1,60 @@
 #include "runtime/ImageLoader.hpp"
 #include "core/Object.hpp"
+#include "core/PixelKernels.hpp"
 #include "render/Image.hpp"
 #include <SDL3_image/SDL_image.h>
 #include <memory>
-std::shared_ptr<Object> ImageLoader::load(const std::string &path) {
-  SDL_Surface *surface = IMG_Load(path.c_str());
-  if (!surface) {
-    _logger->error("Failed to load image '{}': {}", path, SDL_GetError());
-    return nullptr;
+static bool isByteOrderRGBA(SDL_PixelFormat format) {
+  return format == SDL_PIXELFORMAT_RGBA32 || format == SDL_PIXELFORMAT_BGRA32;
+}
+
+SDL_Surface *ImageLoader::normalize(SDL_Surface *surface,
+                                    SDL_PixelFormat format,
+                                    bool premultiplied) {
+  if (surface->format != format) {
+    SDL_Surface *converted = nullptr;
+    if (isByteOrderRGBA(surface->format) && isByteOrderRGBA(format)) {
+      converted = SDL_CreateSurface(surface->w, surface->h, format);
+      for (int y = 0; converted && y < surface->h; ++y) {
+        swizzleRedBlue(static_cast<uint8_t *>(surface->pixels) +
+                           y * surface->pitch,
+                       static_cast<uint8_t *>(converted->pixels) +
+                           y * converted->pitch,
+                       surface->w);
+      }
+    } else {
+      converted = SDL_ConvertSurface(surface, format);
+    }
+    SDL_DestroySurface(surface);
+    surface = converted;
+    if (!surface) {
+      return nullptr;
+    }
+  }
+  if (premultiplied && isByteOrderRGBA(format)) {
+    for (int y = 0; y < surface->h; ++y) {
+      auto row = static_cast<uint8_t *>(surface->pixels) + y * surface->pitch;
+      premultiplyAlpha(row, row, surface->w);
+    }
   }
-  return std::make_shared<Image>(surface);
-}
\ No newline at end of file
+  return surface;
+}
+
+std::shared_ptr<Object> ImageLoader::load(const std::string &path) {
+  auto image = std::make_shared<Image>();
+  auto format = _format;
+  auto premultiplied = _premultiplied && isByteOrderRGBA(format);
+  image->setPremultiplied(premultiplied);
+  image->beginDecode();
+  _decoder->submit([image, path, format, premultiplied, logger = _logger] {
+    SDL_Surface *surface = IMG_Load(path.c_str());
+    if (surface) {
+      surface = normalize(surface, format, premultiplied);
+    }
+    if (!surface) {
+      logger->error("Failed to load image '{}': {}", path, SDL_GetError());
+    }
+    image->endDecode(surface);
+  });
+  return image;
+}
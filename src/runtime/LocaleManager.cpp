@@ -113,6 +113,11 @@ std::string LocaleManager::i18n(
   return result;
 }
 
+void LocaleManager::addLocales(const std::string &source,
+                               const std::string &name) {
+  resolve(_locales, source, name);
+}
+
 void LocaleManager::addLanguage(const std::string &key, const Locale &locale) {
   _languages[key].push_back(locale);
 }
@@ -1,8 +1,202 @@
 #include "runtime/Logger.hpp"
+#include "core/RingBuffer.hpp"
 #include <SDL3/SDL_log.h>
 #include <chrono>
-#include <print>
+#include <cstdlib>
+#include <cstdio>
+#include <thread>
+#include <vector>
 
+class Logger::Backend {
+public:
+  static constexpr size_t CAPACITY = 8192;
+  struct Record {
+    int64_t time = 0;
+    const std::string *category = nullptr;
+    SDL_LogPriority priority = SDL_LOG_PRIORITY_INFO;
+    LogRecord payload;
+  };
+
+private:
+  RingBuffer<Record> _records{CAPACITY};
+  std::atomic<uint32_t> _signal = 0;
+  std::atomic<bool> _sleeping = false;
+  std::atomic<bool> _stopping = false;
+  std::atomic<bool> _stopped = false;
+  // producers between their _stopped check and the end of their push
+  std::atomic<uint32_t> _pushing = 0;
+  std::atomic<FILE *> _output = stdout;
+  std::mutex _direct;
+  std::atomic<uint64_t> _submitted = 0;
+  std::atomic<uint64_t> _written = 0;
+  std::string _line;
+  int64_t _second = INT64_MIN;
+  std::string _dateTime;
+  std::thread _writer;
+
+private:
+  void wake() {
+    _signal.fetch_add(1, std::memory_order_release);
+    _signal.notify_all();
+  }
+
+  const std::string &formatTime(int64_t time) {
+    // only the writer formats dates, and only once per second
+    auto second = time / 1000000000;
+    if (second != _second) {
+      _second = second;
+      std::time_t now = second;
+      std::tm *tm = std::localtime(&now);
+      _dateTime = std::format("{:04}/{:02}/{:02} {:02}:{:02}:{:02}",
+                              tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
+                              tm->tm_hour, tm->tm_min, tm->tm_sec);
+    }
+    return _dateTime;
+  }
+
+  static const char *getKind(SDL_LogPriority priority) {
+    switch (priority) {
+    case SDL_LOG_PRIORITY_INVALID:
+      return "Invalid";
+    case SDL_LOG_PRIORITY_TRACE:
+      return "Trace";
+    case SDL_LOG_PRIORITY_VERBOSE:
+      return "Verbose";
+    case SDL_LOG_PRIORITY_DEBUG:
+      return "Debug";
+    case SDL_LOG_PRIORITY_INFO:
+      return "Info";
+    case SDL_LOG_PRIORITY_WARN:
+      return "Warn";
+    case SDL_LOG_PRIORITY_ERROR:
+      return "Error";
+    case SDL_LOG_PRIORITY_CRITICAL:
+      return "Critical";
+    case SDL_LOG_PRIORITY_COUNT:
+      return "Count";
+    default:
+      return "Unknown";
+    }
+  }
+
+  void output() {
+    auto file = _output.load(std::memory_order_acquire);
+    fwrite(_line.data(), 1, _line.size(), file);
+    fflush(file);
+    _line.clear();
+  }
+
+  void append(const Record &record) {
+    std::format_to(std::back_inserter(_line), "[{}] [{}] [{}]: ",
+                   formatTime(record.time), *record.category,
+                   getKind(record.priority));
+    record.payload.format(_line);
+    _line.push_back('\n');
+  }
+
+  void write() {
+    Record record;
+    for (;;) {
+      auto signal = _signal.load(std::memory_order_acquire);
+      uint64_t count = 0;
+      while (_records.pop(record)) {
+        append(record);
+        count++;
+        if (_line.size() >= 64 * 1024) {
+          output();
+        }
+      }
+      if (count) {
+        output();
+        _written.fetch_add(count, std::memory_order_release);
+        _written.notify_all();
+        continue;
+      }
+      if (_stopping.load(std::memory_order_acquire)) {
+        return;
+      }
+      _sleeping.store(true);
+      if (_written.load() == _submitted.load()) {
+        _signal.wait(signal, std::memory_order_acquire);
+      }
+      _sleeping.store(false);
+    }
+  }
+
+public:
+  Backend() : _writer([this] { write(); }) {}
+
+  // after stop() records are written on the calling thread, which keeps
+  // logging from static destructors working
+  void stop() {
+    std::unique_lock lock(_direct);
+    if (_stopped.exchange(true)) {
+      return;
+    }
+    // records pushed after the final drain would be lost, so wait for the
+    // producers that already passed the check while the writer still runs
+    while (_pushing.load() != 0) {
+      wake();
+      std::this_thread::yield();
+    }
+    _stopping.store(true, std::memory_order_release);
+    wake();
+    _writer.join();
+    Record record;
+    while (_records.pop(record)) {
+      append(record);
+    }
+    output();
+    _written.store(_submitted.load());
+    _written.notify_all();
+  }
+
+  void submit(const std::string *category, SDL_LogPriority priority,
+              LogRecord &&payload) {
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+    Record record = {time, category, priority, std::move(payload)};
+    _pushing.fetch_add(1);
+    if (_stopped.load()) {
+      _pushing.fetch_sub(1);
+      std::unique_lock lock(_direct);
+      append(record);
+      output();
+      return;
+    }
+    _submitted.fetch_add(1);
+    while (!_records.push(std::move(record))) {
+      // the ring is full: make sure the writer runs and wait for it instead of
+      // dropping the message
+      wake();
+      std::this_thread::yield();
+    }
+    _pushing.fetch_sub(1);
+    if (_sleeping.load()) {
+      wake();
+    }
+  }
+
+  void setOutput(FILE *output) {
+    flush();
+    _output.store(output ? output : stdout, std::memory_order_release);
+  }
+
+  void flush() {
+    if (_stopped.load(std::memory_order_acquire)) {
+      return;
+    }
+    auto target = _submitted.load();
+    wake();
+    for (auto written = _written.load(std::memory_order_acquire);
+         written < target; written = _written.load(std::memory_order_acquire)) {
+      _written.wait(written, std::memory_order_acquire);
+    }
+  }
+};
+
+static const std::string UNKNOWN_CATEGORY = "Unkown";
 uint32_t Logger::_maxCategory = (uint32_t)SDL_LOG_CATEGORY_CUSTOM;
 std::unordered_map<int, std::string> Logger::_categoryNames = {
     {SDL_LOG_CATEGORY_APPLICATION, "Application"},
@@ -17,82 +211,122 @@ std::unordered_map<int, std::string> Logger::_categoryNames = {
     {SDL_LOG_CATEGORY_GPU, "GPU"},
 };
 std::unordered_map<std::string, std::unique_ptr<Logger>> Logger::_loggers;
+std::unordered_map<std::string, SDL_LogPriority> Logger::_overrides;
+std::mutex Logger::_mutex;
+SDL_LogPriority Logger::_defaultPriority = SDL_LOG_PRIORITY_INFO;
+
+Logger::Backend &Logger::getBackend() {
+  // never destroyed: loggers are used from other static destructors
+  static Backend *backend = [] {
+    auto backend = new Backend();
+    std::atexit(Logger::shutdown);
+    return backend;
+  }();
+  return *backend;
+}
+void Logger::submit(const std::string *category, SDL_LogPriority priority,
+                    LogRecord &&record) {
+  getBackend().submit(category, priority, std::move(record));
+}
+void Logger::flush() { getBackend().flush(); }
+void Logger::shutdown() { getBackend().stop(); }
+void Logger::setOutput(FILE *output) { getBackend().setOutput(output); }
 void Logger::print(void *userdata, int category, SDL_LogPriority priority,
                    const char *message) {
-  std::string kind;
-  switch (priority) {
-  case SDL_LOG_PRIORITY_INVALID:
-    kind = "Invalid";
-    break;
-  case SDL_LOG_PRIORITY_TRACE:
-    kind = "Trace";
-    break;
-  case SDL_LOG_PRIORITY_VERBOSE:
-    kind = "Verbose";
-    break;
-  case SDL_LOG_PRIORITY_DEBUG:
-    kind = "Debug";
-    break;
-  case SDL_LOG_PRIORITY_INFO:
-    kind = "Info";
-    break;
-  case SDL_LOG_PRIORITY_WARN:
-    kind = "Warn";
-    break;
-  case SDL_LOG_PRIORITY_ERROR:
-    kind = "Error";
-    break;
-  case SDL_LOG_PRIORITY_CRITICAL:
-    kind = "Critical";
-    break;
-  case SDL_LOG_PRIORITY_COUNT:
-    kind = "Count";
-    break;
-  default:
-    kind = "Unknown";
-    break;
-  }
-  std::string categoryName = "Unkown";
-
-  if (_categoryNames.contains(category)) {
-    categoryName = _categoryNames.at(category);
-  }
-  auto now = std::chrono::system_clock::now();
-  std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-  std::tm *now_tm = std::localtime(&now_time);
-  std::string dateTime =
-      std::format("{:04}/{:02}/{:02} {:02}:{:02}:{:02}", now_tm->tm_year + 1900,
-                  now_tm->tm_mon + 1, now_tm->tm_mday, now_tm->tm_hour,
-                  now_tm->tm_min, now_tm->tm_sec);
-  std::println("[{}] [{}] [{}]: {}", dateTime, categoryName, kind, message);
+  const std::string *categoryName = &UNKNOWN_CATEGORY;
+  {
+    std::unique_lock lock(_mutex);
+    auto it = _categoryNames.find(category);
+    if (it != _categoryNames.end()) {
+      categoryName = &it->second;
+    }
+  }
+  LogRecord record;
+  record.setMessage(message);
+  submit(categoryName, priority, std::move(record));
+  if (priority >= SDL_LOG_PRIORITY_CRITICAL) {
+    flush();
+  }
+}
+Logger::Logger(uint32_t category, const std::string *name)
+    : _category(category), _name(name) {}
+SDL_LogPriority Logger::parsePriority(const std::string &name) {
+  if (name == "trace") {
+    return SDL_LOG_PRIORITY_TRACE;
+  } else if (name == "verbose") {
+    return SDL_LOG_PRIORITY_VERBOSE;
+  } else if (name == "debug") {
+    return SDL_LOG_PRIORITY_DEBUG;
+  } else if (name == "info") {
+    return SDL_LOG_PRIORITY_INFO;
+  } else if (name == "warn") {
+    return SDL_LOG_PRIORITY_WARN;
+  } else if (name == "error") {
+    return SDL_LOG_PRIORITY_ERROR;
+  } else if (name == "critical") {
+    return SDL_LOG_PRIORITY_CRITICAL;
+  }
+  return SDL_LOG_PRIORITY_INVALID;
+}
+void Logger::setPriority(SDL_LogPriority priority) {
+  SDL_SetLogPriority(_category, priority);
+  _priority.store(priority, std::memory_order_relaxed);
 }
-Logger::Logger(uint32_t category) : _category(category) {}
+// "debug" sets every category, "info,Render=debug" overrides single ones
 void Logger::setPriorities(const std::string &logPriorities) {
-  if (logPriorities == "trace") {
-    SDL_SetLogPriorities(SDL_LOG_PRIORITY_TRACE);
-  } else if (logPriorities == "verbose") {
-    SDL_SetLogPriorities(SDL_LOG_PRIORITY_VERBOSE);
-  } else if (logPriorities == "debug") {
-    SDL_SetLogPriorities(SDL_LOG_PRIORITY_DEBUG);
-  } else if (logPriorities == "info") {
-    SDL_SetLogPriorities(SDL_LOG_PRIORITY_INFO);
-  } else if (logPriorities == "warn") {
-    SDL_SetLogPriorities(SDL_LOG_PRIORITY_WARN);
-  } else if (logPriorities == "error") {
-    SDL_SetLogPriorities(SDL_LOG_PRIORITY_ERROR);
-  } else if (logPriorities == "critical") {
-    SDL_SetLogPriorities(SDL_LOG_PRIORITY_CRITICAL);
-  } else {
+  // reported after unlocking: print() takes the same lock
+  std::vector<std::string> invalid;
+  std::unique_lock lock(_mutex);
+  size_t start = 0;
+  while (start <= logPriorities.size()) {
+    auto end = logPriorities.find(',', start);
+    if (end == std::string::npos) {
+      end = logPriorities.size();
+    }
+    auto item = logPriorities.substr(start, end - start);
+    start = end + 1;
+    if (item.empty()) {
+      continue;
+    }
+    auto pos = item.find('=');
+    auto priority = parsePriority(
+        pos == std::string::npos ? item : item.substr(pos + 1));
+    if (priority == SDL_LOG_PRIORITY_INVALID) {
+      invalid.push_back(item);
+      continue;
+    }
+    if (pos == std::string::npos) {
+      _defaultPriority = priority;
+      _overrides.clear();
+      SDL_SetLogPriorities(priority);
+      for (auto &[_, logger] : _loggers) {
+        logger->setPriority(priority);
+      }
+    } else {
+      auto category = item.substr(0, pos);
+      _overrides[category] = priority;
+      if (_loggers.contains(category)) {
+        _loggers.at(category)->setPriority(priority);
+      }
+    }
+  }
+  lock.unlock();
+  for (auto &item : invalid) {
     SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Unknown log priority: %s",
-                logPriorities.c_str());
+                item.c_str());
   }
 }
 Logger *Logger::getLogger(const std::string &category) {
+  std::unique_lock lock(_mutex);
   auto &plogger = _loggers[category];
   if (!plogger) {
-    plogger.reset(new Logger(_maxCategory));
-    _categoryNames[_maxCategory] = category;
+    auto &name = _categoryNames[_maxCategory];
+    name = category;
+    plogger.reset(new Logger(_maxCategory, &name));
+    auto it = _overrides.find(category);
+    plogger->setPriority(it != _overrides.end() ? it->second
+                                                : _defaultPriority);
     _maxCategory++;
   }
   return plogger.get();
-}
\ No newline at end of file
+}
@@ -0,0 +1,217 @@
+#include "runtime/SaveFile.hpp"
+#include <SDL3/SDL.h>
+#include <bit>
+static constexpr uint32_t MAX_DEPTH = 64;
+static constexpr uint32_t MAX_STRING = 64 * 1024 * 1024;
+
+static bool writeString(SDL_IOStream *io, const std::string &value) {
+  return SDL_WriteU32LE(io, value.size()) &&
+         SDL_WriteIO(io, value.data(), value.size()) == value.size();
+}
+static bool readString(SDL_IOStream *io, std::string &value) {
+  uint32_t size = 0;
+  if (!SDL_ReadU32LE(io, &size)) {
+    return false;
+  }
+  if (size > MAX_STRING) {
+    SDL_SetError("Invalid save string length: %u", size);
+    return false;
+  }
+  value.resize(size);
+  return SDL_ReadIO(io, value.data(), size) == size;
+}
+
+bool SaveFile::writeHeader(SDL_IOStream *io, const Header &header) {
+  return SDL_WriteU32LE(io, MAGIC) && SDL_WriteU32LE(io, header.version) &&
+         SDL_WriteU64LE(io, header.indexOffset) &&
+         SDL_WriteU32LE(io, header.indexSize) &&
+         SDL_WriteU32LE(io, header.flags) && SDL_WriteU32LE(io, header.base) &&
+         SDL_WriteU32LE(io, header.generation);
+}
+
+bool SaveFile::readHeader(SDL_IOStream *io, Header &header) {
+  uint32_t magic = 0;
+  if (!SDL_ReadU32LE(io, &magic) || !SDL_ReadU32LE(io, &header.version) ||
+      !SDL_ReadU64LE(io, &header.indexOffset) ||
+      !SDL_ReadU32LE(io, &header.indexSize) ||
+      !SDL_ReadU32LE(io, &header.flags)) {
+    return false;
+  }
+  if (magic != MAGIC) {
+    SDL_SetError("Not a save file");
+    return false;
+  }
+  if (header.version == 0 || header.version > VERSION) {
+    SDL_SetError("Unsupported save version: %u", header.version);
+    return false;
+  }
+  if (header.version < 2) {
+    header.base = 0;
+    header.generation = 0;
+    return true;
+  }
+  return SDL_ReadU32LE(io, &header.base) &&
+         SDL_ReadU32LE(io, &header.generation);
+}
+
+bool SaveFile::writeIndex(SDL_IOStream *io, const std::vector<Entry> &index) {
+  for (auto &entry : index) {
+    if (!SDL_WriteU8(io, static_cast<uint8_t>(entry.type)) ||
+        !SDL_WriteU8(io, entry.codec) || !SDL_WriteU16LE(io, entry.layer) ||
+        !SDL_WriteS32LE(io, entry.x) || !SDL_WriteS32LE(io, entry.y) ||
+        !SDL_WriteU32LE(io, entry.size) || !SDL_WriteU32LE(io, entry.rawSize) ||
+        !SDL_WriteU64LE(io, entry.offset) || !SDL_WriteU32LE(io, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SaveFile::readIndex(SDL_IOStream *io, const Header &header,
+                         std::vector<Entry> &index) {
+  auto size = SDL_GetIOSize(io);
+  auto headerSize = getHeaderSize(header.version);
+  if (size < 0 || header.indexOffset < headerSize ||
+      header.indexOffset + uint64_t(header.indexSize) * ENTRY_SIZE >
+          static_cast<uint64_t>(size)) {
+    SDL_SetError("Invalid save index");
+    return false;
+  }
+  if (SDL_SeekIO(io, header.indexOffset, SDL_IO_SEEK_SET) < 0) {
+    return false;
+  }
+  index.resize(header.indexSize);
+  for (auto &entry : index) {
+    uint8_t type = 0;
+    uint32_t reserved = 0;
+    if (!SDL_ReadU8(io, &type) || !SDL_ReadU8(io, &entry.codec) ||
+        !SDL_ReadU16LE(io, &entry.layer) || !SDL_ReadS32LE(io, &entry.x) ||
+        !SDL_ReadS32LE(io, &entry.y) || !SDL_ReadU32LE(io, &entry.size) ||
+        !SDL_ReadU32LE(io, &entry.rawSize) ||
+        !SDL_ReadU64LE(io, &entry.offset) || !SDL_ReadU32LE(io, &reserved)) {
+      return false;
+    }
+    entry.type = static_cast<Section>(type);
+    if (entry.offset < headerSize ||
+        entry.offset + entry.size > header.indexOffset) {
+      SDL_SetError("Invalid save section offset");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SaveFile::writeVariable(SDL_IOStream *io, const Variable &value) {
+  auto type = value.getType();
+  if (!SDL_WriteU8(io, static_cast<uint8_t>(type))) {
+    return false;
+  }
+  switch (type) {
+  case Variable::Type::NIL:
+    return true;
+  case Variable::Type::NUMBER:
+    return SDL_WriteU32LE(io, std::bit_cast<uint32_t>(value.getNumber()));
+  case Variable::Type::STRING:
+    return writeString(io, value.getString());
+  case Variable::Type::BOOLEAN:
+    return SDL_WriteU8(io, value.getBoolean());
+  case Variable::Type::ARRAY: {
+    auto &array = value.getArray();
+    if (!SDL_WriteU32LE(io, array.size())) {
+      return false;
+    }
+    for (auto &item : array) {
+      if (!writeVariable(io, item)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  case Variable::Type::OBJECT: {
+    auto &object = value.getObject();
+    if (!SDL_WriteU32LE(io, object.size())) {
+      return false;
+    }
+    for (auto &[key, item] : object) {
+      if (!writeString(io, key) || !writeVariable(io, item)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  }
+  return false;
+}
+
+bool SaveFile::readVariable(SDL_IOStream *io, Variable &value,
+                            uint32_t depth) {
+  uint8_t type = 0;
+  if (!SDL_ReadU8(io, &type)) {
+    return false;
+  }
+  if (depth > MAX_DEPTH) {
+    SDL_SetError("Save variable nested too deeply");
+    return false;
+  }
+  switch (static_cast<Variable::Type>(type)) {
+  case Variable::Type::NIL:
+    value.setNil();
+    return true;
+  case Variable::Type::NUMBER: {
+    uint32_t bits = 0;
+    if (!SDL_ReadU32LE(io, &bits)) {
+      return false;
+    }
+    value.setNumber(std::bit_cast<float>(bits));
+    return true;
+  }
+  case Variable::Type::STRING: {
+    std::string string;
+    if (!readString(io, string)) {
+      return false;
+    }
+    value.setString(string);
+    return true;
+  }
+  case Variable::Type::BOOLEAN: {
+    uint8_t boolean = 0;
+    if (!SDL_ReadU8(io, &boolean)) {
+      return false;
+    }
+    value.setBoolean(boolean != 0);
+    return true;
+  }
+  case Variable::Type::ARRAY: {
+    uint32_t count = 0;
+    if (!SDL_ReadU32LE(io, &count)) {
+      return false;
+    }
+    value.setArray();
+    auto array = value.getArray();
+    for (uint32_t index = 0; index < count; ++index) {
+      if (!readVariable(io, array->emplace_back(), depth + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  case Variable::Type::OBJECT: {
+    uint32_t count = 0;
+    if (!SDL_ReadU32LE(io, &count)) {
+      return false;
+    }
+    value.setObject();
+    auto object = value.getObject();
+    for (uint32_t index = 0; index < count; ++index) {
+      std::string key;
+      if (!readString(io, key) ||
+          !readVariable(io, (*object)[key], depth + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  }
+  SDL_SetError("Unknown save variable type: %d", type);
+  return false;
+}
@@ -1,10 +1,303 @@
 #include "runtime/SaveManager.hpp"
 #include "runtime/Application.hpp"
+#include <chrono>
+#include <exception>
 #include <filesystem>
+#include <random>
 SaveManager::SaveManager() {
   auto app = Application::getInstance();
   _savePath = app->getCWD() + "saves/";
   if (!std::filesystem::exists(_savePath)) {
     std::filesystem::create_directory(_savePath);
   }
-}
\ No newline at end of file
+}
+SaveManager::~SaveManager() { waitAutosave(); }
+std::shared_ptr<TileWorld> SaveManager::openWorld(const std::string &name) {
+  try {
+    return std::make_shared<TileWorld>(_savePath + name + "/regions/");
+  } catch (std::exception &e) {
+    _logger->error("Failed to open world '{}': {}", name, e.what());
+  }
+  return nullptr;
+}
+
+std::vector<std::shared_ptr<TileWorld>>
+SaveManager::getWorlds(const TileMap &map) {
+  std::vector<std::shared_ptr<TileWorld>> worlds;
+  for (size_t index = 0; index < map.getLayerCount(); ++index) {
+    worlds.push_back(map.getLayer(index)->getWorld());
+  }
+  return worlds;
+}
+
+static Variable makePair(const std::pair<uint32_t, uint32_t> &value) {
+  Variable pair;
+  pair.setArray();
+  pair.push(Variable().setNumber(value.first));
+  pair.push(Variable().setNumber(value.second));
+  return pair;
+}
+static std::pair<uint32_t, uint32_t> getPair(const Variable &value) {
+  auto &array = value.getArray();
+  if (array.size() != 2) {
+    return {0, 0};
+  }
+  return {static_cast<uint32_t>(array[0].getNumber()),
+          static_cast<uint32_t>(array[1].getNumber())};
+}
+
+std::unique_ptr<SaveWriter>
+SaveManager::prepare(const std::string &name, TileMap &map,
+                     const Variable &metadata, std::vector<Variable> entities) {
+  try {
+    std::filesystem::create_directories(_savePath + name);
+  } catch (std::exception &e) {
+    _logger->error("Failed to create save '{}': {}", name, e.what());
+    return nullptr;
+  }
+  bool loaded = finishLoad();
+  SaveState state;
+  bool delta = false;
+  if (_tracked == name) {
+    std::unique_lock lock(_mutex);
+    auto it = _states.find(name);
+    delta = it != _states.end() && it->second.generation < _maxDeltas &&
+            it->second.deltaBytes <= it->second.baseBytes * _compactRatio;
+    if (delta) {
+      state = it->second;
+    }
+  }
+  if (!delta && !loaded) {
+    // a full save would drop the chunks the closed reader never installed
+    _logger->error("Failed to save '{}': the last load was closed before "
+                   "all chunks were installed",
+                   name);
+    return nullptr;
+  }
+  std::unique_ptr<SaveWriter> writer;
+  if (delta) {
+    writer = std::make_unique<SaveWriter>(
+        getDeltaFile(name, state.generation + 1));
+    writer->setGeneration(state.base, state.generation + 1);
+  } else {
+    static std::random_device random;
+    uint32_t base = 0;
+    while (base == 0) {
+      base = random();
+    }
+    writer = std::make_unique<SaveWriter>(getSaveFile(name));
+    writer->setGeneration(base, 0);
+  }
+  _tracked = name;
+  Variable layout;
+  layout.setObject();
+  layout.setField("size", makePair(map.getSize()));
+  layout.setField("tileSize", makePair(map.getTileSize()));
+  Variable layers;
+  layers.setArray();
+  for (size_t index = 0; index < map.getLayerCount(); ++index) {
+    auto &layer = map.getLayer(index);
+    Variable info;
+    info.setObject();
+    info.setField("texture", Variable().setString(layer->getTexture()));
+    info.setField("zIndex", Variable().setNumber(layer->getZIndex()));
+    info.setField("layer", Variable().setNumber(layer->getLayer()));
+    info.setField("static", Variable().setBoolean(layer->isStatic()));
+    layers.push(info);
+    writer->addLayer(index, *layer->getWorld(), delta);
+  }
+  layout.setField("layers", layers);
+  writer->setMap(layout);
+  writer->setMetadata(metadata);
+  writer->setEntities(std::move(entities));
+  return writer;
+}
+
+void SaveManager::finish(const std::string &name, const SaveWriter &writer,
+                         bool ok) {
+  auto &stats = writer.getStats();
+  {
+    std::unique_lock lock(_mutex);
+    if (!ok) {
+      // the snapshot consumed the worlds' changes, so rewrite the base
+      _states.erase(name);
+      return;
+    }
+    if (writer.getGeneration() != 0) {
+      auto &state = _states[name];
+      state.generation = writer.getGeneration();
+      state.deltaBytes += stats.fileBytes;
+      return;
+    }
+    _states[name] = {writer.getBase(), 0, stats.fileBytes, 0};
+  }
+  removeDeltas(name);
+}
+
+bool SaveManager::finishLoad() {
+  if (!_reader) {
+    return true;
+  }
+  _reader->finish(_loading);
+  if (!_reader->isComplete()) {
+    return false;
+  }
+  _reader = nullptr;
+  _loading.clear();
+  return true;
+}
+
+void SaveManager::removeDeltas(const std::string &name) {
+  std::error_code error;
+  for (auto &entry :
+       std::filesystem::directory_iterator(_savePath + name, error)) {
+    auto file = entry.path().filename().string();
+    if (file.starts_with("world.") && file.ends_with(".delta")) {
+      std::filesystem::remove(entry.path(), error);
+    }
+  }
+}
+
+bool SaveManager::save(const std::string &name, TileMap &map,
+                       const Variable &metadata,
+                       std::vector<Variable> entities) {
+  waitAutosave();
+  auto writer = prepare(name, map, metadata, std::move(entities));
+  if (!writer) {
+    return false;
+  }
+  bool ok = writer->commit();
+  finish(name, *writer, ok);
+  if (!ok) {
+    return false;
+  }
+  auto &stats = writer->getStats();
+  _logger->info("Saved '{}' ({}): {} sections, {} -> {} bytes in {:.1f}ms",
+                name, writer->getGeneration() ? "delta" : "full",
+                stats.sections, stats.rawBytes, stats.fileBytes,
+                stats.seconds * 1000);
+  return true;
+}
+
+bool SaveManager::autosave(const std::string &name, TileMap &map,
+                           const Variable &metadata,
+                           std::vector<Variable> entities) {
+  if (_autosaving.exchange(true)) {
+    std::unique_lock lock(_mutex);
+    _autosaveStats.skipped++;
+    _logger->warn("Autosave of '{}' skipped: previous one still writing", name);
+    return false;
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<SaveWriter> writer =
+      prepare(name, map, metadata, std::move(entities));
+  auto snapshotTime = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+  {
+    std::unique_lock lock(_mutex);
+    _autosaveStats.snapshotTime = snapshotTime;
+    _autosaveStats.maxSnapshotTime =
+        std::max(_autosaveStats.maxSnapshotTime, snapshotTime);
+  }
+  if (!writer) {
+    _autosaving = false;
+    return false;
+  }
+  if (!_autosaver) {
+    _autosaver = std::make_unique<ThreadPool>(1);
+  }
+  _autosaver->submit([this, name, writer, snapshotTime] {
+    bool ok = writer->commit();
+    finish(name, *writer, ok);
+    auto &stats = writer->getStats();
+    {
+      std::unique_lock lock(_mutex);
+      if (ok) {
+        _autosaveStats.count++;
+        if (writer->getGeneration() != 0) {
+          _autosaveStats.deltas++;
+        }
+        _autosaveStats.writeTime = stats.seconds;
+        _autosaveStats.fileBytes = stats.fileBytes;
+      } else {
+        _autosaveStats.failed++;
+      }
+    }
+    if (ok) {
+      _logger->info("Autosaved '{}' ({}): snapshot {:.2f}ms, write {:.1f}ms, "
+                    "{} bytes",
+                    name, writer->getGeneration() ? "delta" : "full",
+                    snapshotTime * 1000, stats.seconds * 1000,
+                    stats.fileBytes);
+    }
+    _autosaving = false;
+  });
+  return true;
+}
+
+void SaveManager::waitAutosave() {
+  if (_autosaver) {
+    _autosaver->wait();
+  }
+}
+
+SaveManager::AutosaveStats SaveManager::getAutosaveStats() const {
+  std::unique_lock lock(_mutex);
+  return _autosaveStats;
+}
+
+std::shared_ptr<SaveReader> SaveManager::load(const std::string &name,
+                                              TileMap &map, Variable &metadata,
+                                              std::vector<Variable> &entities) {
+  waitAutosave();
+  std::vector<std::string> files = {getSaveFile(name)};
+  while (std::filesystem::exists(getDeltaFile(name, files.size()))) {
+    files.push_back(getDeltaFile(name, files.size()));
+  }
+  auto reader = std::make_shared<SaveReader>();
+  if (!reader->open(files)) {
+    return nullptr;
+  }
+  Variable layout;
+  if (!reader->readMap(layout) || !reader->readMetadata(metadata) ||
+      !reader->readEntities(entities)) {
+    _logger->error("Failed to load save '{}': {}", name, SDL_GetError());
+    return nullptr;
+  }
+  const Variable &info = layout;
+  map.setSize(getPair(info.getField("size")));
+  map.setTileSize(getPair(info.getField("tileSize")));
+  auto layers = info.getField("layers").getArray();
+  for (size_t index = 0; index < layers.size(); ++index) {
+    auto layer = index < map.getLayerCount() ? map.getLayer(index)
+                                              : map.addLayer();
+    const Variable &item = layers[index];
+    layer->setTexture(item.getField("texture").getString(layer->getTexture()));
+    layer->setZIndex(item.getField("zIndex").getNumber());
+    layer->setLayer(item.getField("layer").getNumber());
+    layer->setStatic(item.getField("static").getBoolean());
+  }
+  _loading = getWorlds(map);
+  for (auto &world : _loading) {
+    if (world) {
+      world->reset();
+    }
+  }
+  _reader = reader;
+  _tracked = name;
+  std::unique_lock lock(_mutex);
+  if (reader->getFileCount() < files.size()) {
+    // deltas past a broken link could match a future generation number
+    _states.erase(name);
+    return reader;
+  }
+  SaveState state{reader->getBase(), reader->getGeneration(), 0, 0};
+  std::error_code error;
+  for (size_t index = 0; index < files.size(); ++index) {
+    auto size = std::filesystem::file_size(files[index], error);
+    (index == 0 ? state.baseBytes : state.deltaBytes) += error ? 0 : size;
+  }
+  _states[name] = state;
+  return reader;
+}
@@ -0,0 +1,258 @@
+#include "runtime/SaveReader.hpp"
+#include "core/Compression.hpp"
+#include "core/Profiler.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <tuple>
+SaveReader::~SaveReader() { close(); }
+
+bool SaveReader::open(const std::string &path) {
+  return open(std::vector<std::string>{path});
+}
+
+bool SaveReader::open(const std::vector<std::string> &paths) {
+  close();
+  if (paths.empty()) {
+    return false;
+  }
+  _path = paths.front();
+  _revision = TileChunk::getLatestRevision();
+  using Source = std::pair<SaveFile::Entry, size_t>;
+  std::vector<Source> sections;
+  std::map<std::tuple<uint16_t, int32_t, int32_t>, Source> chunks;
+  for (auto &path : paths) {
+    bool base = _files.empty();
+    auto file = SDL_IOFromFile(path.c_str(), "rb");
+    SaveFile::Header header;
+    std::vector<SaveFile::Entry> index;
+    if (!file || !SaveFile::readHeader(file, header) ||
+        !SaveFile::readIndex(file, header, index)) {
+      if (file) {
+        SDL_CloseIO(file);
+      }
+      if (base) {
+        _logger->error("Failed to read save '{}': {}", path, SDL_GetError());
+        close();
+        return false;
+      }
+      _logger->warn("Ignoring unreadable save delta '{}': {}", path,
+                    SDL_GetError());
+      break;
+    }
+    bool delta = header.flags & SaveFile::FLAG_DELTA;
+    if (base && delta) {
+      _logger->error("Save '{}' is a delta without its base", path);
+      SDL_CloseIO(file);
+      close();
+      return false;
+    }
+    if (!base && (!delta || header.base != _header.base ||
+                  header.generation != _generation + 1)) {
+      _logger->warn("Ignoring save delta '{}' outside the chain", path);
+      SDL_CloseIO(file);
+      break;
+    }
+    if (base) {
+      _header = header;
+    }
+    _generation = header.generation;
+    // every file carries complete metadata, map and entities
+    sections.clear();
+    for (auto &entry : index) {
+      Source source{entry, _files.size()};
+      if (entry.type == SaveFile::Section::CHUNK) {
+        chunks[{entry.layer, entry.x, entry.y}] = source;
+      } else {
+        sections.push_back(source);
+      }
+    }
+    _files.push_back(file);
+  }
+  for (auto &[_, source] : chunks) {
+    sections.push_back(source);
+  }
+  for (auto &[entry, file] : sections) {
+    _index.push_back(entry);
+    _sources.push_back(file);
+  }
+  for (size_t index = 0; index < _index.size(); ++index) {
+    if (_index[index].type == SaveFile::Section::CHUNK) {
+      _pending.push_back(index);
+    }
+  }
+  _chunkCount = _pending.size();
+  _decoder = std::make_unique<ThreadPool>(
+      std::max(1u, std::thread::hardware_concurrency() / 2));
+  return true;
+}
+
+void SaveReader::close() {
+  _decoder.reset();
+  for (auto file : _files) {
+    SDL_CloseIO(file);
+  }
+  _files.clear();
+  _header = {};
+  _generation = 0;
+  _index.clear();
+  _sources.clear();
+  _pending.clear();
+  _loaded.clear();
+  _sorted = false;
+  _chunkCount = 0;
+  _inFlight = 0;
+  _installed = 0;
+  _failed = 0;
+}
+
+size_t SaveReader::findSection(SaveFile::Section type, int32_t x) const {
+  for (size_t index = 0; index < _index.size(); ++index) {
+    if (_index[index].type == type && _index[index].x == x) {
+      return index;
+    }
+  }
+  return SIZE_MAX;
+}
+
+bool SaveReader::readSection(size_t index, Buffer &data) {
+  auto &entry = _index[index];
+  if (entry.codec != SaveFile::CODEC_ZSTD) {
+    SDL_SetError("Unknown save codec: %d", entry.codec);
+    return false;
+  }
+  data.reset(entry.size);
+  auto file = _files[_sources[index]];
+  std::unique_lock lock(_fileMutex);
+  return SDL_SeekIO(file, entry.offset, SDL_IO_SEEK_SET) >= 0 &&
+         SDL_ReadIO(file, data.getData(), entry.size) == entry.size;
+}
+
+bool SaveReader::readVariable(SaveFile::Section type, Variable &value) {
+  auto index = findSection(type);
+  Buffer data;
+  if (index == SIZE_MAX || !readSection(index, data)) {
+    return false;
+  }
+  auto stream = Compression::openReader(data.getData(), data.getSize());
+  if (!stream) {
+    return false;
+  }
+  bool ok = SaveFile::readVariable(stream, value);
+  return SDL_CloseIO(stream) && ok;
+}
+
+bool SaveReader::readEntities(std::vector<Variable> &entities) {
+  Buffer data;
+  for (int32_t batch = 0;; ++batch) {
+    auto index = findSection(SaveFile::Section::ENTITIES, batch);
+    if (index == SIZE_MAX) {
+      return true;
+    }
+    if (!readSection(index, data)) {
+      return false;
+    }
+    auto stream = Compression::openReader(data.getData(), data.getSize());
+    if (!stream) {
+      return false;
+    }
+    uint32_t count = 0;
+    bool ok = SDL_ReadU32LE(stream, &count);
+    for (uint32_t index = 0; ok && index < count; ++index) {
+      ok = SaveFile::readVariable(stream, entities.emplace_back());
+    }
+    if (!SDL_CloseIO(stream) || !ok) {
+      return false;
+    }
+  }
+}
+
+void SaveReader::setFocus(int32_t cx, int32_t cy) {
+  if (cx != _focusX || cy != _focusY) {
+    _focusX = cx;
+    _focusY = cy;
+    _sorted = false;
+  }
+}
+
+void SaveReader::request(size_t index) {
+  _inFlight++;
+  _decoder->submit([this, index] {
+    auto &entry = _index[index];
+    Loaded loaded{entry.layer, entry.x, entry.y, {}};
+    Buffer data;
+    bool ok = readSection(index, data);
+    if (ok) {
+      auto stream = Compression::openReader(data.getData(), data.getSize());
+      ok = stream && loaded.chunk.read(stream);
+      ok = stream && SDL_CloseIO(stream) && ok;
+    }
+    if (!ok) {
+      _logger->error("Failed to read chunk {},{} of layer {}: {}", entry.x,
+                     entry.y, entry.layer, SDL_GetError());
+      loaded.layer = UINT16_MAX;
+    }
+    std::unique_lock lock(_mutex);
+    _loaded.push_back(std::move(loaded));
+  });
+}
+
+size_t SaveReader::poll(const std::vector<std::shared_ptr<TileWorld>> &worlds,
+                        size_t budget) {
+  PROFILE_ZONE("SaveReader::poll");
+  if (_files.empty()) {
+    return 0;
+  }
+  if (!_sorted) {
+    // pending is consumed from the back, so the nearest chunk goes last
+    std::sort(_pending.begin(), _pending.end(), [this](size_t a, size_t b) {
+      auto distance = [this](const SaveFile::Entry &entry) {
+        return std::max(std::abs(entry.x - _focusX),
+                        std::abs(entry.y - _focusY));
+      };
+      return distance(_index[a]) > distance(_index[b]);
+    });
+    _sorted = true;
+  }
+  std::vector<Loaded> loaded;
+  {
+    std::unique_lock lock(_mutex);
+    if (_loaded.size() <= budget) {
+      loaded.swap(_loaded);
+    } else {
+      auto split = _loaded.end() - budget;
+      loaded.assign(std::make_move_iterator(split),
+                    std::make_move_iterator(_loaded.end()));
+      _loaded.erase(split, _loaded.end());
+    }
+  }
+  _inFlight -= loaded.size();
+  size_t installed = 0;
+  for (auto &[layer, cx, cy, chunk] : loaded) {
+    if (layer >= worlds.size() || !worlds[layer]) {
+      _failed++;
+      continue;
+    }
+    // chunks edited since open() keep the player's version
+    worlds[layer]->loadChunk(cx, cy, std::move(chunk), _revision);
+    installed++;
+  }
+  _installed += installed;
+  while (_inFlight < MAX_IN_FLIGHT && !_pending.empty()) {
+    request(_pending.back());
+    _pending.pop_back();
+  }
+  return installed;
+}
+
+void SaveReader::finish(
+    const std::vector<std::shared_ptr<TileWorld>> &worlds) {
+  while (!_files.empty() && !isComplete()) {
+    poll(worlds);
+    if (!isComplete()) {
+      _decoder->wait();
+    }
+  }
+}
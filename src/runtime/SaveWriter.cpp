@@ -0,0 +1,199 @@
+#include "runtime/SaveWriter.hpp"
+#include "core/Profiler.hpp"
+#include "core/ThreadPool.hpp"
+#include <SDL3/SDL.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static bool syncFile(SDL_IOStream *io) {
+  if (!SDL_FlushIO(io)) {
+    return false;
+  }
+  auto properties = SDL_GetIOProperties(io);
+#ifdef _WIN32
+  auto handle = SDL_GetPointerProperty(
+      properties, SDL_PROP_IOSTREAM_WINDOWS_HANDLE_POINTER, nullptr);
+  return !handle || FlushFileBuffers(handle);
+#else
+  auto file = static_cast<FILE *>(SDL_GetPointerProperty(
+      properties, SDL_PROP_IOSTREAM_STDIO_FILE_POINTER, nullptr));
+  return !file || fsync(fileno(file)) == 0;
+#endif
+}
+
+// Makes the rename itself durable. Windows has no equivalent for directories.
+static bool syncDirectory(const std::string &path) {
+#ifdef _WIN32
+  return true;
+#else
+  auto directory = std::filesystem::path(path).parent_path().string();
+  auto fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = fsync(fd) == 0;
+  ::close(fd);
+  return ok;
+#endif
+}
+
+SaveWriter::SaveWriter(const std::string &path) : _path(path) {}
+
+void SaveWriter::addLayer(uint16_t layer, TileWorld &world, bool changes) {
+  _layers.push_back({layer, world.snapshot(changes)});
+}
+
+bool SaveWriter::encode(const Job &job, Buffer &output,
+                        uint32_t &rawSize) const {
+  auto stream = Compression::openWriter(output, _level);
+  if (!stream) {
+    return false;
+  }
+  bool ok = true;
+  switch (job.entry.type) {
+  case SaveFile::Section::CHUNK:
+    ok = job.chunk->write(stream);
+    break;
+  case SaveFile::Section::ENTITIES:
+    ok = SDL_WriteU32LE(stream, job.count);
+    for (size_t index = 0; ok && index < job.count; ++index) {
+      ok = SaveFile::writeVariable(stream, _entities[job.first + index]);
+    }
+    break;
+  default:
+    ok = SaveFile::writeVariable(stream, *job.variable);
+    break;
+  }
+  rawSize = static_cast<uint32_t>(SDL_TellIO(stream));
+  return SDL_CloseIO(stream) && ok;
+}
+
+bool SaveWriter::commit() {
+  PROFILE_ZONE("SaveWriter::commit");
+  auto start = std::chrono::steady_clock::now();
+  _stats = {};
+  std::vector<Job> jobs;
+  jobs.push_back({{.type = SaveFile::Section::METADATA}, &_metadata});
+  jobs.push_back({{.type = SaveFile::Section::MAP}, &_map});
+  for (auto &layer : _layers) {
+    if (!TileWorld::loadPaged(layer.snapshot)) {
+      _logger->error("Failed to read paged region of layer {}: {}",
+                     layer.layer, SDL_GetError());
+      return false;
+    }
+    for (auto &record : layer.snapshot.chunks) {
+      Job job{{.type = SaveFile::Section::CHUNK,
+               .layer = layer.layer,
+               .x = record.cx,
+               .y = record.cy}};
+      job.chunk = record.chunk.get();
+      jobs.push_back(job);
+    }
+  }
+  for (size_t first = 0; first < _entities.size(); first += ENTITY_BATCH) {
+    Job job{{.type = SaveFile::Section::ENTITIES,
+             .x = static_cast<int32_t>(first / ENTITY_BATCH)}};
+    job.first = first;
+    job.count = std::min(ENTITY_BATCH, _entities.size() - first);
+    jobs.push_back(job);
+  }
+
+  auto temp = _path + ".tmp";
+  auto file = SDL_IOFromFile(temp.c_str(), "wb");
+  if (!file) {
+    _logger->error("Failed to create save '{}': {}", temp, SDL_GetError());
+    return false;
+  }
+  SaveFile::Header header;
+  header.flags = _generation ? SaveFile::FLAG_DELTA : 0;
+  header.base = _base;
+  header.generation = _generation;
+  bool ok = SaveFile::writeHeader(file, header);
+
+  struct Done {
+    SaveFile::Entry entry;
+    Buffer data;
+    bool ok;
+    // SDL errors are per thread, so the pool thread's one is kept here
+    std::string error;
+  };
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<Done> done;
+  {
+    ThreadPool pool(_threads);
+    for (auto &job : jobs) {
+      pool.submit([&, job] {
+        Done result{job.entry, {}, false, {}};
+        result.ok = encode(job, result.data, result.entry.rawSize);
+        if (!result.ok) {
+          result.error = SDL_GetError();
+        }
+        result.entry.size = result.data.getSize();
+        std::unique_lock lock(mutex);
+        done.push_back(std::move(result));
+        ready.notify_one();
+      });
+    }
+    std::vector<SaveFile::Entry> index;
+    index.reserve(jobs.size());
+    uint64_t offset = SaveFile::getHeaderSize(header.version);
+    while (index.size() < jobs.size()) {
+      std::unique_lock lock(mutex);
+      ready.wait(lock, [&] { return !done.empty(); });
+      auto result = std::move(done.front());
+      done.pop_front();
+      lock.unlock();
+      if (!result.ok) {
+        _logger->error("Failed to encode save section: {}", result.error);
+        ok = false;
+      }
+      result.entry.offset = offset;
+      if (ok && SDL_WriteIO(file, result.data.getData(),
+                            result.data.getSize()) != result.data.getSize()) {
+        ok = false;
+      }
+      offset += result.entry.size;
+      _stats.rawBytes += result.entry.rawSize;
+      index.push_back(result.entry);
+    }
+    header.indexOffset = offset;
+    header.indexSize = index.size();
+    ok = ok && SaveFile::writeIndex(file, index) &&
+         SDL_SeekIO(file, 0, SDL_IO_SEEK_SET) == 0 &&
+         SaveFile::writeHeader(file, header) && syncFile(file);
+    _stats.sections = index.size();
+    _stats.fileBytes = offset + index.size() * SaveFile::ENTRY_SIZE;
+  }
+  if (!SDL_CloseIO(file)) {
+    ok = false;
+  }
+  if (!ok) {
+    _logger->error("Failed to write save '{}': {}", _path, SDL_GetError());
+    std::filesystem::remove(temp);
+    return false;
+  }
+  std::error_code error;
+  std::filesystem::rename(temp, _path, error);
+  if (error) {
+    _logger->error("Failed to replace save '{}': {}", _path, error.message());
+    return false;
+  }
+  if (!syncDirectory(_path)) {
+    _logger->warn("Failed to sync save directory of '{}'", _path);
+  }
+  _stats.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return true;
+}
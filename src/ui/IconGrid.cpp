@@ -0,0 +1,150 @@
+#include "ui/IconGrid.hpp"
+#include <algorithm>
+#include <format>
+void IconGrid::updateCursor() {
+  if (_selected < 0) {
+    setCursorRect({});
+    return;
+  }
+  setCursorRect({(_selected % _columns) * _slotSize,
+                 (_selected / _columns) * _slotSize, _slotSize, _slotSize});
+}
+
+void IconGrid::setSlotCount(size_t count) {
+  _slots.resize(count);
+  _counts.resize(count);
+  if (_selected >= static_cast<int32_t>(count)) {
+    setSelected(static_cast<int32_t>(count) - 1);
+  }
+  markDirty();
+}
+
+void IconGrid::setSlot(size_t index, const Slot &slot) {
+  if (index >= _slots.size()) {
+    return;
+  }
+  auto &current = _slots[index];
+  if (current.icon != slot.icon) {
+    markDirty();
+  }
+  current = slot;
+  if (slot.count > 1) {
+    if (!_counts[index]) {
+      _counts[index] = std::make_unique<Text>();
+      _counts[index]->setFont(_font);
+      _counts[index]->setSize(_fontSize);
+    }
+    _counts[index]->setText(std::format("{}", slot.count));
+  } else {
+    _counts[index] = nullptr;
+  }
+}
+
+void IconGrid::setFont(const std::string &font, float size) {
+  _font = font;
+  _fontSize = size;
+  for (auto &count : _counts) {
+    if (count) {
+      count->setFont(font);
+      count->setSize(size);
+    }
+  }
+}
+
+void IconGrid::setSelected(int32_t index) {
+  _selected = std::clamp(index, -1, static_cast<int32_t>(_slots.size()) - 1);
+  updateCursor();
+}
+
+void IconGrid::build(RenderSystem *renderSystem,
+                     std::vector<Fragment> &fragments) {
+  Window::build(renderSystem, fragments);
+  _loading.clear();
+  for (size_t index = 0; index < _slots.size(); ++index) {
+    auto &slot = _slots[index];
+    if (slot.icon.empty()) {
+      continue;
+    }
+    auto texture = renderSystem->getTextureHandle(slot.icon);
+    auto image = renderSystem->getTexture(texture);
+    if (!renderSystem->isTextureReady(texture)) {
+      _loading.push_back(texture);
+    }
+    float w = image ? std::min<float>(image->w, _slotSize) : _slotSize;
+    float h = image ? std::min<float>(image->h, _slotSize) : _slotSize;
+    auto x = PADDING + (index % _columns) * _slotSize + (_slotSize - w) / 2;
+    auto y = PADDING + (index / _columns) * _slotSize + (_slotSize - h) / 2;
+    auto &fragment = fragments.emplace_back();
+    fragment.setTexture(texture);
+    fragment.setZIndex(2);
+    fragment.setRect({x, y, w, h});
+    fragment.setClipRect({0, 0, w, h});
+  }
+}
+
+void IconGrid::drawContents(RenderSystem *renderSystem,
+                            const SDL_FPoint &origin) {
+  Window::drawContents(renderSystem, origin);
+  if (std::ranges::any_of(_loading, [&](uint32_t texture) {
+        return renderSystem->isTextureReady(texture);
+      })) {
+    markDirty();
+  }
+  for (size_t index = 0; index < _counts.size(); ++index) {
+    auto &count = _counts[index];
+    if (!count) {
+      continue;
+    }
+    auto &bounds = count->getBounds(renderSystem);
+    count->setLayer(_layer);
+    count->setZIndex(_depth + 3);
+    count->setPosition(
+        {origin.x + PADDING + (index % _columns + 1) * _slotSize - bounds.x,
+         origin.y + PADDING + (index / _columns + 1) * _slotSize - bounds.y});
+    count->draw(renderSystem);
+  }
+}
+
+bool IconGrid::onMouseButtonDown(const SDL_MouseButtonEvent &event,
+                                 const SDL_FPoint &point) {
+  if (event.button != SDL_BUTTON_LEFT || _slotSize <= 0) {
+    return false;
+  }
+  auto x = (point.x - PADDING) / _slotSize;
+  auto y = (point.y - PADDING) / _slotSize;
+  if (x < 0 || y < 0 || x >= _columns) {
+    return false;
+  }
+  auto index = static_cast<size_t>(y) * _columns + static_cast<size_t>(x);
+  if (index >= _slots.size()) {
+    return false;
+  }
+  setSelected(index);
+  return true;
+}
+
+bool IconGrid::onKeyDown(const SDL_KeyboardEvent &event) {
+  if (_slots.empty()) {
+    return false;
+  }
+  auto selected = std::max(_selected, 0);
+  int32_t columns = _columns;
+  switch (event.key) {
+  case SDLK_LEFT:
+    setSelected(std::max(selected - 1, 0));
+    return true;
+  case SDLK_RIGHT:
+    setSelected(selected + 1);
+    return true;
+  case SDLK_UP:
+    setSelected(selected >= columns ? selected - columns : selected);
+    return true;
+  case SDLK_DOWN:
+    setSelected(selected + columns < static_cast<int32_t>(_slots.size())
+                    ? selected + columns
+                    : selected);
+    return true;
+  default:
+    return false;
+  }
+}
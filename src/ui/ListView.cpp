@@ -0,0 +1,107 @@
+#include "ui/ListView.hpp"
+#include <algorithm>
+uint32_t ListView::getVisibleCount() const {
+  auto height = _rect.h - PADDING * 2;
+  if (height <= 0 || _itemHeight <= 0) {
+    return 0;
+  }
+  return static_cast<uint32_t>(height / _itemHeight);
+}
+
+void ListView::updateCursor() {
+  if (_selected < 0) {
+    setCursorRect({});
+    return;
+  }
+  auto visible = std::max(getVisibleCount(), 1u);
+  if (static_cast<uint32_t>(_selected) < _top) {
+    _top = _selected;
+  } else if (static_cast<uint32_t>(_selected) >= _top + visible) {
+    _top = _selected - visible + 1;
+  }
+  setCursorRect({0, (_selected - _top) * _itemHeight, _rect.w - PADDING * 2,
+                 _itemHeight});
+}
+
+void ListView::setItems(const std::vector<std::string> &items) {
+  _items.resize(items.size());
+  for (size_t index = 0; index < items.size(); ++index) {
+    if (!_items[index]) {
+      _items[index] = std::make_unique<Text>();
+      _items[index]->setFont(_font);
+      _items[index]->setSize(_fontSize);
+    }
+    _items[index]->setText(items[index]);
+  }
+  if (_selected >= static_cast<int32_t>(_items.size())) {
+    _selected = static_cast<int32_t>(_items.size()) - 1;
+  }
+  _top = std::min<uint32_t>(_top, _items.size());
+  updateCursor();
+}
+
+void ListView::setItem(size_t index, const std::string &item) {
+  if (index < _items.size()) {
+    _items[index]->setText(item);
+  }
+}
+
+void ListView::setFont(const std::string &font, float size) {
+  _font = font;
+  _fontSize = size;
+  for (auto &item : _items) {
+    item->setFont(font);
+    item->setSize(size);
+  }
+}
+
+void ListView::setSelected(int32_t index) {
+  _selected = std::clamp(index, -1, static_cast<int32_t>(_items.size()) - 1);
+  updateCursor();
+}
+
+void ListView::drawContents(RenderSystem *renderSystem,
+                            const SDL_FPoint &origin) {
+  Window::drawContents(renderSystem, origin);
+  auto end = std::min<size_t>(_top + getVisibleCount(), _items.size());
+  for (size_t index = _top; index < end; ++index) {
+    auto &item = _items[index];
+    item->setLayer(_layer);
+    item->setZIndex(_depth + 2);
+    item->setPosition({origin.x + PADDING + 4,
+                       origin.y + PADDING + (index - _top) * _itemHeight});
+    item->draw(renderSystem);
+  }
+}
+
+bool ListView::onMouseButtonDown(const SDL_MouseButtonEvent &event,
+                                 const SDL_FPoint &point) {
+  if (event.button != SDL_BUTTON_LEFT || _itemHeight <= 0) {
+    return false;
+  }
+  auto row = (point.y - PADDING) / _itemHeight;
+  if (row < 0 || row >= getVisibleCount()) {
+    return false;
+  }
+  auto index = _top + static_cast<uint32_t>(row);
+  if (index >= _items.size()) {
+    return false;
+  }
+  setSelected(index);
+  return true;
+}
+
+bool ListView::onKeyDown(const SDL_KeyboardEvent &event) {
+  if (_items.empty()) {
+    return false;
+  }
+  if (event.key == SDLK_UP) {
+    setSelected(std::max(_selected - 1, 0));
+    return true;
+  }
+  if (event.key == SDLK_DOWN) {
+    setSelected(_selected + 1);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,19 @@
+#include "ui/UIManager.hpp"
+void UIManager::resize(float width, float height) {
+  _root->setRect({0, 0, width, height});
+}
+
+bool UIManager::onMouseButtonDown(const SDL_MouseButtonEvent &event) {
+  return _root->dispatchMouseButtonDown(event, {event.x, event.y});
+}
+
+bool UIManager::onKeyDown(const SDL_KeyboardEvent &event) {
+  return _focus && _focus->isVisible() && _focus->onKeyDown(event);
+}
+
+void UIManager::update(uint64_t ticks) { _root->update(ticks); }
+
+void UIManager::draw(RenderSystem *renderSystem) {
+  int32_t depth = 0;
+  _root->draw(renderSystem, {}, _layer, depth);
+}
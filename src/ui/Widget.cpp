@@ -0,0 +1,68 @@
+#include "ui/Widget.hpp"
+#include <algorithm>
+void Widget::addChild(const std::shared_ptr<Widget> &child) {
+  if (child->_parent) {
+    child->_parent->removeChild(child);
+  }
+  child->_parent = this;
+  _children.push_back(child);
+}
+
+void Widget::removeChild(const std::shared_ptr<Widget> &child) {
+  auto it = std::find(_children.begin(), _children.end(), child);
+  if (it != _children.end()) {
+    (*it)->_parent = nullptr;
+    _children.erase(it);
+  }
+}
+
+void Widget::update(uint64_t ticks) {
+  for (auto &child : _children) {
+    child->update(ticks);
+  }
+}
+
+bool Widget::dispatchMouseButtonDown(const SDL_MouseButtonEvent &event,
+                                     const SDL_FPoint &point) {
+  if (!_visible || point.x < _rect.x || point.y < _rect.y ||
+      point.x >= _rect.x + _rect.w || point.y >= _rect.y + _rect.h) {
+    return false;
+  }
+  SDL_FPoint local = {point.x - _rect.x, point.y - _rect.y};
+  for (auto it = _children.rbegin(); it != _children.rend(); ++it) {
+    if ((*it)->dispatchMouseButtonDown(event, local)) {
+      return true;
+    }
+  }
+  return onMouseButtonDown(event, local);
+}
+
+void Widget::draw(RenderSystem *renderSystem, const SDL_FPoint &origin,
+                  uint8_t layer, int32_t &depth) {
+  if (!_visible) {
+    return;
+  }
+  // geometry is generated in local space with z relative to the widget,
+  // it is only regenerated when the widget or its draw order changes
+  if (_layer != layer || _depth != depth) {
+    _layer = layer;
+    _depth = depth;
+    _dirty = true;
+  }
+  if (_dirty) {
+    _fragments.clear();
+    build(renderSystem, _fragments);
+    for (auto &fragment : _fragments) {
+      fragment.setLayer(_layer);
+      fragment.setZIndex(_depth + fragment.getZIndex());
+    }
+    _dirty = false;
+  }
+  depth += DEPTH_STEP;
+  SDL_FPoint position = {origin.x + _rect.x, origin.y + _rect.y};
+  renderSystem->draw(_fragments.data(), _fragments.size(), position);
+  drawContents(renderSystem, position);
+  for (auto &child : _children) {
+    child->draw(renderSystem, position, layer, depth);
+  }
+}
@@ -0,0 +1,71 @@
+#include "ui/Window.hpp"
+#include <algorithm>
+void Window::addNineSlice(std::vector<Fragment> &fragments, uint32_t texture,
+                          const SDL_FRect &source, float border,
+                          const SDL_FRect &target, uint8_t alpha,
+                          bool center) {
+  auto edgeX = std::min(border, target.w / 2);
+  auto edgeY = std::min(border, target.h / 2);
+  float sourceX[] = {source.x, source.x + border,
+                     source.x + source.w - border, source.x + source.w};
+  float sourceY[] = {source.y, source.y + border,
+                     source.y + source.h - border, source.y + source.h};
+  float targetX[] = {target.x, target.x + edgeX, target.x + target.w - edgeX,
+                     target.x + target.w};
+  float targetY[] = {target.y, target.y + edgeY, target.y + target.h - edgeY,
+                     target.y + target.h};
+  for (int row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      auto w = targetX[column + 1] - targetX[column];
+      auto h = targetY[row + 1] - targetY[row];
+      if (w <= 0 || h <= 0 || (!center && row == 1 && column == 1)) {
+        continue;
+      }
+      auto &fragment = fragments.emplace_back();
+      fragment.setTexture(texture);
+      fragment.setAlpha(alpha);
+      fragment.setRect({targetX[column], targetY[row], w, h});
+      fragment.setClipRect({sourceX[column], sourceY[row],
+                            sourceX[column + 1] - sourceX[column],
+                            sourceY[row + 1] - sourceY[row]});
+    }
+  }
+}
+
+void Window::build(RenderSystem *renderSystem,
+                   std::vector<Fragment> &fragments) {
+  if (_skin.empty() || _rect.w <= 0 || _rect.h <= 0) {
+    return;
+  }
+  // RMXP windowskin: 128x128 background, 64x64 frame and 32x32 cursor
+  auto texture = renderSystem->getTextureHandle(_skin);
+  auto background = static_cast<uint8_t>(_opacity * _backOpacity / 255);
+  auto &back = fragments.emplace_back();
+  back.setTexture(texture);
+  back.setAlpha(background);
+  back.setRect({2, 2, _rect.w - 4, _rect.h - 4});
+  back.setClipRect({0, 0, 128, 128});
+  // the frame's centre holds the scroll arrows, only its border is drawn
+  addNineSlice(fragments, texture, {128, 0, 64, 64}, BORDER,
+               {0, 0, _rect.w, _rect.h}, _opacity, false);
+}
+
+void Window::drawContents(RenderSystem *renderSystem,
+                          const SDL_FPoint &origin) {
+  if (_cursorDirty) {
+    _cursor.clear();
+    if (!_skin.empty() && _cursorRect.w > 0 && _cursorRect.h > 0) {
+      addNineSlice(_cursor, renderSystem->getTextureHandle(_skin),
+                   {128, 64, 32, 32}, CURSOR_BORDER,
+                   {_cursorRect.x + PADDING, _cursorRect.y + PADDING,
+                    _cursorRect.w, _cursorRect.h},
+                   _opacity);
+    }
+    _cursorDirty = false;
+  }
+  for (auto &fragment : _cursor) {
+    fragment.setLayer(_layer);
+    fragment.setZIndex(_depth + 1);
+  }
+  renderSystem->draw(_cursor.data(), _cursor.size(), origin);
+}
@@ -0,0 +1,373 @@
+#include "world/TileChunk.hpp"
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <unordered_map>
+static constexpr uint8_t CHUNK_EMPTY = 0;
+static constexpr uint8_t CHUNK_DIRECT = 1;
+static constexpr uint8_t CHUNK_UNIFORM = 2;
+static constexpr uint8_t CHUNK_PALETTE = 3;
+static constexpr uint8_t INDEX_PACKED = 0;
+static constexpr uint8_t INDEX_RLE = 1;
+static constexpr uint8_t MAX_PALETTE_BITS = 3;
+
+static uint8_t getPaletteBits(size_t size) {
+  uint8_t bits = 0;
+  while (bits < MAX_PALETTE_BITS && (1u << (1u << bits)) < size) {
+    bits++;
+  }
+  return bits;
+}
+
+static std::atomic<uint64_t> revisions = 0;
+uint64_t TileChunk::nextRevision() { return ++revisions; }
+uint64_t TileChunk::getLatestRevision() { return revisions.load(); }
+TileChunk::TileChunk() : _revision(nextRevision()) {}
+
+uint32_t TileChunk::findPalette(uint32_t tile) {
+  for (uint32_t i = 0; i < _palette.size(); ++i) {
+    if (_palette[i] == tile) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+void TileChunk::repack(uint8_t bits) {
+  std::vector<uint32_t> palette;
+  std::vector<uint16_t> counts;
+  std::vector<uint32_t> remap(_palette.size(), 0);
+  for (uint32_t i = 0; i < _palette.size(); ++i) {
+    if (_counts[i]) {
+      remap[i] = palette.size();
+      palette.push_back(_palette[i]);
+      counts.push_back(_counts[i]);
+    }
+  }
+  std::vector<uint32_t> indices(AREA);
+  for (uint32_t i = 0; i < AREA; ++i) {
+    indices[i] = remap[readIndex(i)];
+  }
+  _bits = bits;
+  _data.assign(AREA >> (5 - _bits), 0);
+  for (uint32_t i = 0; i < AREA; ++i) {
+    writeIndex(i, indices[i]);
+  }
+  _palette.swap(palette);
+  _counts.swap(counts);
+}
+
+void TileChunk::fromTiles(const std::vector<uint32_t> &tiles) {
+  std::unordered_map<uint32_t, uint32_t> lookup;
+  std::vector<uint32_t> palette;
+  for (auto &tile : tiles) {
+    if (lookup.try_emplace(tile, palette.size()).second) {
+      palette.push_back(tile);
+      if (palette.size() > (1u << (1u << MAX_PALETTE_BITS))) {
+        break;
+      }
+    }
+  }
+  _palette.clear();
+  _counts.clear();
+  _data.clear();
+  if (palette.size() == 1) {
+    _encoding = Encoding::UNIFORM;
+    _uniform = palette[0];
+    _live = 0;
+  } else if (palette.size() > (1u << (1u << MAX_PALETTE_BITS))) {
+    _encoding = Encoding::DIRECT;
+    _data = tiles;
+    _live = 0;
+  } else {
+    _encoding = Encoding::PALETTE;
+    _bits = getPaletteBits(palette.size());
+    _palette = palette;
+    _counts.assign(palette.size(), 0);
+    _live = palette.size();
+    _data.assign(AREA >> (5 - _bits), 0);
+    for (uint32_t i = 0; i < AREA; ++i) {
+      auto index = lookup.at(tiles[i]);
+      writeIndex(i, index);
+      _counts[index]++;
+    }
+  }
+  _palette.shrink_to_fit();
+  _counts.shrink_to_fit();
+  _data.shrink_to_fit();
+}
+
+void TileChunk::toTiles(std::vector<uint32_t> &tiles) const {
+  tiles.resize(AREA);
+  for (uint32_t i = 0; i < AREA; ++i) {
+    tiles[i] = getTile(i % SIZE, i / SIZE);
+  }
+}
+
+void TileChunk::setPaletteTile(uint32_t index, uint32_t tile) {
+  auto slot = findPalette(tile);
+  if (slot == UINT32_MAX) {
+    for (uint32_t i = 0; i < _counts.size(); ++i) {
+      if (_counts[i] == 0) {
+        slot = i;
+        break;
+      }
+    }
+    if (slot == UINT32_MAX) {
+      if (_palette.size() >= (1u << (1u << _bits))) {
+        if (_bits == MAX_PALETTE_BITS) {
+          std::vector<uint32_t> tiles;
+          toTiles(tiles);
+          tiles[index] = tile;
+          _encoding = Encoding::DIRECT;
+          _data.swap(tiles);
+          _palette.clear();
+          _palette.shrink_to_fit();
+          _counts.clear();
+          _counts.shrink_to_fit();
+          _live = 0;
+          _changes = 0;
+          return;
+        }
+        repack(_bits + 1);
+      }
+      slot = _palette.size();
+      _palette.push_back(0);
+      _counts.push_back(0);
+    }
+    _palette[slot] = tile;
+  }
+  auto old = readIndex(index);
+  writeIndex(index, slot);
+  if (_counts[slot]++ == 0) {
+    _live++;
+  }
+  if (--_counts[old] != 0) {
+    return;
+  }
+  _live--;
+  if (_live == 1) {
+    _encoding = Encoding::UNIFORM;
+    _uniform = tile;
+    _palette.clear();
+    _palette.shrink_to_fit();
+    _counts.clear();
+    _counts.shrink_to_fit();
+    _data.clear();
+    _data.shrink_to_fit();
+    _live = 0;
+  } else if (_bits > 0 && _live <= (1u << (1u << (_bits - 1))) / 2) {
+    repack(_bits - 1);
+  }
+}
+
+void TileChunk::setTile(uint32_t x, uint32_t y, uint32_t tile) {
+  auto index = y * SIZE + x;
+  switch (_encoding) {
+  case Encoding::UNIFORM:
+    if (_uniform == tile) {
+      return;
+    }
+    _encoding = Encoding::PALETTE;
+    _bits = 0;
+    _palette = {_uniform};
+    _counts = {static_cast<uint16_t>(AREA)};
+    _live = 1;
+    _data.assign(AREA >> 5, 0);
+    setPaletteTile(index, tile);
+    break;
+  case Encoding::PALETTE:
+    if (_palette[readIndex(index)] == tile) {
+      return;
+    }
+    setPaletteTile(index, tile);
+    break;
+  case Encoding::DIRECT:
+    if (_data[index] == tile) {
+      return;
+    }
+    _data[index] = tile;
+    if (++_changes >= AREA) {
+      _changes = 0;
+      compact();
+    }
+    break;
+  }
+  _revision = nextRevision();
+}
+
+void TileChunk::compact() {
+  if (_encoding == Encoding::DIRECT) {
+    std::vector<uint32_t> tiles = _data;
+    fromTiles(tiles);
+  } else if (_encoding == Encoding::PALETTE) {
+    auto bits = getPaletteBits(_live);
+    if (bits != _bits || _palette.size() != _live) {
+      repack(bits);
+    }
+  }
+}
+
+size_t TileChunk::getMemoryUsage() const {
+  return sizeof(TileChunk) + _palette.capacity() * sizeof(uint32_t) +
+         _counts.capacity() * sizeof(uint16_t) +
+         _data.capacity() * sizeof(uint32_t);
+}
+
+bool TileChunk::write(SDL_IOStream *io) const {
+  if (isEmpty()) {
+    return SDL_WriteU8(io, CHUNK_EMPTY);
+  }
+  if (_encoding == Encoding::UNIFORM) {
+    return SDL_WriteU8(io, CHUNK_UNIFORM) && SDL_WriteU32LE(io, _uniform);
+  }
+  if (_encoding == Encoding::DIRECT) {
+    if (!SDL_WriteU8(io, CHUNK_DIRECT)) {
+      return false;
+    }
+    for (auto &tile : _data) {
+      if (!SDL_WriteU32LE(io, tile)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (!SDL_WriteU8(io, CHUNK_PALETTE) ||
+      !SDL_WriteU16LE(io, _palette.size()) || !SDL_WriteU8(io, _bits)) {
+    return false;
+  }
+  for (auto &tile : _palette) {
+    if (!SDL_WriteU32LE(io, tile)) {
+      return false;
+    }
+  }
+  std::vector<std::pair<uint16_t, uint16_t>> runs;
+  for (uint32_t i = 0; i < AREA; ++i) {
+    auto value = readIndex(i);
+    if (!runs.empty() && runs.back().second == value) {
+      runs.back().first++;
+    } else {
+      runs.push_back({1, value});
+    }
+  }
+  if (runs.size() < _data.size()) {
+    if (!SDL_WriteU8(io, INDEX_RLE) || !SDL_WriteU16LE(io, runs.size())) {
+      return false;
+    }
+    for (auto &[length, value] : runs) {
+      if (!SDL_WriteU16LE(io, length) || !SDL_WriteU16LE(io, value)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (!SDL_WriteU8(io, INDEX_PACKED)) {
+    return false;
+  }
+  for (auto &word : _data) {
+    if (!SDL_WriteU32LE(io, word)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Decodes into `tiles` only, so a failed read leaves the chunk untouched.
+static bool readTiles(SDL_IOStream *io, std::vector<uint32_t> &tiles) {
+  uint8_t encoding = 0;
+  if (!SDL_ReadU8(io, &encoding)) {
+    return false;
+  }
+  if (encoding == CHUNK_EMPTY) {
+    return true;
+  }
+  if (encoding == CHUNK_UNIFORM) {
+    uint32_t tile = 0;
+    if (!SDL_ReadU32LE(io, &tile)) {
+      return false;
+    }
+    tiles.assign(TileChunk::AREA, tile);
+    return true;
+  }
+  if (encoding == CHUNK_DIRECT) {
+    for (auto &tile : tiles) {
+      if (!SDL_ReadU32LE(io, &tile)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (encoding != CHUNK_PALETTE) {
+    SDL_SetError("Unknown tile chunk encoding: %d", encoding);
+    return false;
+  }
+  uint16_t size = 0;
+  uint8_t bits = 0;
+  uint8_t mode = 0;
+  if (!SDL_ReadU16LE(io, &size) || !SDL_ReadU8(io, &bits)) {
+    return false;
+  }
+  if (bits > MAX_PALETTE_BITS || size == 0 || size > (1u << (1u << bits))) {
+    SDL_SetError("Invalid tile chunk palette");
+    return false;
+  }
+  std::vector<uint32_t> palette(size);
+  for (auto &tile : palette) {
+    if (!SDL_ReadU32LE(io, &tile)) {
+      return false;
+    }
+  }
+  if (!SDL_ReadU8(io, &mode)) {
+    return false;
+  }
+  if (mode == INDEX_RLE) {
+    uint16_t count = 0;
+    if (!SDL_ReadU16LE(io, &count)) {
+      return false;
+    }
+    uint32_t offset = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+      uint16_t length = 0;
+      uint16_t value = 0;
+      if (!SDL_ReadU16LE(io, &length) || !SDL_ReadU16LE(io, &value)) {
+        return false;
+      }
+      if (value >= size || offset + length > TileChunk::AREA) {
+        SDL_SetError("Invalid tile chunk run");
+        return false;
+      }
+      for (uint16_t j = 0; j < length; ++j) {
+        tiles[offset++] = palette[value];
+      }
+    }
+  } else {
+    auto shift = 5 - bits;
+    auto mask = (1u << (1u << bits)) - 1;
+    std::vector<uint32_t> data(TileChunk::AREA >> shift, 0);
+    for (auto &word : data) {
+      if (!SDL_ReadU32LE(io, &word)) {
+        return false;
+      }
+    }
+    for (uint32_t i = 0; i < TileChunk::AREA; ++i) {
+      auto offset = (i & ((1u << shift) - 1)) << bits;
+      auto value = (data[i >> shift] >> offset) & mask;
+      if (value >= size) {
+        SDL_SetError("Invalid tile chunk index");
+        return false;
+      }
+      tiles[i] = palette[value];
+    }
+  }
+  return true;
+}
+
+bool TileChunk::read(SDL_IOStream *io) {
+  std::vector<uint32_t> tiles(AREA, 0);
+  if (!readTiles(io, tiles)) {
+    return false;
+  }
+  fromTiles(tiles);
+  _revision = nextRevision();
+  _changes = 0;
+  return true;
+}
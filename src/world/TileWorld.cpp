@@ -0,0 +1,547 @@
+#include "world/TileWorld.hpp"
+#include "core/Profiler.hpp"
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_iostream.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+static constexpr uint32_t REGION_MAGIC = 0x47524954; // "TIRG"
+static constexpr uint32_t REGION_VERSION = 2;
+
+TileWorld::TileWorld(const std::string &path) : _path(path) {
+  if (!_path.empty()) {
+    if (!_path.ends_with("/") && !_path.ends_with("\\")) {
+      _path += "/";
+    }
+    if (!std::filesystem::exists(_path)) {
+      std::filesystem::create_directories(_path);
+    }
+    // links left behind by snapshots that never finished
+    for (auto &entry : std::filesystem::directory_iterator(_path)) {
+      if (entry.path().filename().string().find(".snapshot") !=
+          std::string::npos) {
+        std::filesystem::remove(entry.path());
+      }
+    }
+    _io = std::make_unique<ThreadPool>(1);
+  }
+}
+TileWorld::~TileWorld() { flush(); }
+
+const std::shared_ptr<TileChunk> &TileWorld::getEmptyChunk() {
+  static const std::shared_ptr<TileChunk> empty = std::make_shared<TileChunk>();
+  return empty;
+}
+TileChunk &TileWorld::detach(std::shared_ptr<TileChunk> &chunk) {
+  if (chunk.use_count() > 1) {
+    chunk = std::make_shared<TileChunk>(*chunk);
+  }
+  return *chunk;
+}
+
+uint64_t TileWorld::makeKey(int32_t rx, int32_t ry) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(rx)) << 32) |
+         static_cast<uint32_t>(ry);
+}
+int32_t TileWorld::floorDiv(int32_t value, int32_t divisor) {
+  auto result = value / divisor;
+  if ((value % divisor != 0) && ((value < 0) != (divisor < 0))) {
+    result--;
+  }
+  return result;
+}
+std::string TileWorld::getRegionPath(uint64_t key) const {
+  return _path + std::format("{}.{}.region", static_cast<int32_t>(key >> 32),
+                             static_cast<int32_t>(key & 0xffffffff));
+}
+
+bool TileWorld::readRegion(const std::string &path, Region &region) {
+  auto file = SDL_IOFromFile(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t count = 0;
+  if (!SDL_ReadU32LE(file, &magic) || !SDL_ReadU32LE(file, &version) ||
+      !SDL_ReadU32LE(file, &count)) {
+    SDL_CloseIO(file);
+    return false;
+  }
+  if (magic != REGION_MAGIC || version == 0 || version > REGION_VERSION ||
+      count != region.chunks.size()) {
+    SDL_SetError("Invalid region header: %s", path.c_str());
+    SDL_CloseIO(file);
+    return false;
+  }
+  for (auto &chunk : region.chunks) {
+    uint32_t length = 0;
+    auto loaded = std::make_shared<TileChunk>();
+    if (!SDL_ReadU32LE(file, &length) || !loaded->read(file)) {
+      SDL_CloseIO(file);
+      return false;
+    }
+    chunk = loaded->isEmpty() ? getEmptyChunk() : loaded;
+  }
+  SDL_CloseIO(file);
+  return true;
+}
+
+bool TileWorld::writeRegion(const std::string &path, const Region &region) {
+  auto temp = path + ".tmp";
+  auto file = SDL_IOFromFile(temp.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = SDL_WriteU32LE(file, REGION_MAGIC) &&
+            SDL_WriteU32LE(file, REGION_VERSION) &&
+            SDL_WriteU32LE(file, region.chunks.size());
+  for (auto &chunk : region.chunks) {
+    if (!ok) {
+      break;
+    }
+    auto start = SDL_TellIO(file);
+    ok = SDL_WriteU32LE(file, 0) && chunk->write(file);
+    if (ok) {
+      auto end = SDL_TellIO(file);
+      ok = SDL_SeekIO(file, start, SDL_IO_SEEK_SET) >= 0 &&
+           SDL_WriteU32LE(file, static_cast<uint32_t>(end - start - 4)) &&
+           SDL_SeekIO(file, end, SDL_IO_SEEK_SET) >= 0;
+    }
+  }
+  if (!SDL_CloseIO(file)) {
+    ok = false;
+  }
+  if (!ok) {
+    std::filesystem::remove(temp);
+    return false;
+  }
+  std::error_code error;
+  std::filesystem::rename(temp, path, error);
+  if (error) {
+    SDL_SetError("%s", error.message().c_str());
+    return false;
+  }
+  return true;
+}
+
+TileWorld::Region *TileWorld::findRegion(uint64_t key) {
+  if (key == _lastKey) {
+    return _lastRegion;
+  }
+  auto it = _regions.find(key);
+  if (it == _regions.end()) {
+    return nullptr;
+  }
+  _lastKey = key;
+  _lastRegion = it->second.get();
+  return _lastRegion;
+}
+
+TileWorld::Region *TileWorld::acquireRegion(uint64_t key) {
+  auto region = findRegion(key);
+  if (region) {
+    return region;
+  }
+  std::shared_ptr<Region> resident;
+  if (_writeBack.contains(key)) {
+    resident = std::make_shared<Region>(*_writeBack.at(key));
+    resident->dirty = true;
+  } else {
+    resident = std::make_shared<Region>();
+    auto path = getRegionPath(key);
+    if (!_path.empty() && std::filesystem::exists(path)) {
+      if (!readRegion(path, *resident)) {
+        _logger->error("Failed to read region '{}': {}", path, SDL_GetError());
+        resident = std::make_shared<Region>();
+      }
+    }
+  }
+  resident->lastUsed = _frame;
+  _regions[key] = resident;
+  _lastKey = key;
+  _lastRegion = resident.get();
+  return _lastRegion;
+}
+
+void TileWorld::requestLoad(uint64_t key) {
+  if (_loading.contains(key)) {
+    return;
+  }
+  _loading.insert(key);
+  auto path = getRegionPath(key);
+  _io->submit([this, key, path] {
+    auto region = std::make_shared<Region>();
+    if (std::filesystem::exists(path) && !readRegion(path, *region)) {
+      _logger->error("Failed to read region '{}': {}", path, SDL_GetError());
+      region = std::make_shared<Region>();
+    }
+    std::unique_lock lock(_mutex);
+    _loaded.push_back({key, region});
+  });
+}
+
+void TileWorld::requestStore(uint64_t key,
+                             const std::shared_ptr<Region> &region) {
+  _writeBack[key] = region;
+  auto path = getRegionPath(key);
+  _io->submit([this, key, path, region] {
+    if (!writeRegion(path, *region)) {
+      _logger->error("Failed to write region '{}': {}", path, SDL_GetError());
+      return;
+    }
+    std::unique_lock lock(_mutex);
+    _stored.push_back({key, region.get()});
+  });
+}
+
+void TileWorld::collect() {
+  std::vector<LoadResult> loaded;
+  std::vector<StoreResult> stored;
+  {
+    std::unique_lock lock(_mutex);
+    loaded.swap(_loaded);
+    stored.swap(_stored);
+  }
+  for (auto &[key, region] : loaded) {
+    _loading.erase(key);
+    if (_regions.contains(key) || _writeBack.contains(key)) {
+      continue;
+    }
+    region->lastUsed = _frame;
+    _regions[key] = region;
+  }
+  for (auto &[key, region] : stored) {
+    auto it = _writeBack.find(key);
+    if (it != _writeBack.end() && it->second.get() == region) {
+      _writeBack.erase(it);
+    }
+  }
+}
+
+size_t TileWorld::getRegionMemory(const Region &region) const {
+  size_t size = sizeof(Region);
+  for (auto &chunk : region.chunks) {
+    size += sizeof(chunk);
+    if (chunk != getEmptyChunk()) {
+      size += chunk->getMemoryUsage();
+    }
+  }
+  return size;
+}
+
+size_t TileWorld::getMemoryUsage() const {
+  size_t size = 0;
+  for (auto &[_, region] : _regions) {
+    size += getRegionMemory(*region);
+  }
+  for (auto &[_, region] : _writeBack) {
+    size += getRegionMemory(*region);
+  }
+  return size;
+}
+
+void TileWorld::evict(const std::unordered_set<uint64_t> &keep) {
+  if (_path.empty()) {
+    return;
+  }
+  auto usage = getMemoryUsage();
+  if (usage <= _memoryLimit) {
+    _overLimit = false;
+    return;
+  }
+  std::vector<std::pair<uint64_t, uint64_t>> candidates;
+  for (auto &[key, region] : _regions) {
+    if (!keep.contains(key)) {
+      candidates.push_back({region->lastUsed, key});
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  for (auto &[_, key] : candidates) {
+    if (usage <= _memoryLimit) {
+      break;
+    }
+    auto region = _regions.at(key);
+    usage -= getRegionMemory(*region);
+    if (region->changed) {
+      _changed[key] |= region->changed;
+    }
+    if (region->dirty) {
+      region->dirty = false;
+      requestStore(key, region);
+    }
+    _regions.erase(key);
+  }
+  _lastKey = UINT64_MAX;
+  _lastRegion = nullptr;
+  if (usage > _memoryLimit && !_overLimit) {
+    _logger->warn("Visible regions exceed memory limit: {} > {}", usage,
+                  _memoryLimit);
+  }
+  _overLimit = usage > _memoryLimit;
+}
+
+uint32_t TileWorld::getTile(int32_t x, int32_t y) {
+  auto rx = floorDiv(x, REGION_TILES);
+  auto ry = floorDiv(y, REGION_TILES);
+  auto region = findRegion(makeKey(rx, ry));
+  if (!region) {
+    return 0;
+  }
+  uint32_t lx = x - rx * REGION_TILES;
+  uint32_t ly = y - ry * REGION_TILES;
+  auto &chunk = region->chunks[(ly / TileChunk::SIZE) * REGION_SIZE +
+                               lx / TileChunk::SIZE];
+  return chunk->getTile(lx % TileChunk::SIZE, ly % TileChunk::SIZE);
+}
+
+void TileWorld::setTile(int32_t x, int32_t y, uint32_t tile) {
+  auto rx = floorDiv(x, REGION_TILES);
+  auto ry = floorDiv(y, REGION_TILES);
+  auto region = acquireRegion(makeKey(rx, ry));
+  uint32_t lx = x - rx * REGION_TILES;
+  uint32_t ly = y - ry * REGION_TILES;
+  auto index = (ly / TileChunk::SIZE) * REGION_SIZE + lx / TileChunk::SIZE;
+  auto &chunk = region->chunks[index];
+  auto cx = lx % TileChunk::SIZE;
+  auto cy = ly % TileChunk::SIZE;
+  if (chunk->getTile(cx, cy) != tile) {
+    detach(chunk).setTile(cx, cy, tile);
+    region->dirty = true;
+    region->changed |= 1ull << index;
+  }
+}
+
+const TileChunk *TileWorld::getChunk(int32_t cx, int32_t cy) {
+  auto rx = floorDiv(cx, REGION_SIZE);
+  auto ry = floorDiv(cy, REGION_SIZE);
+  auto region = findRegion(makeKey(rx, ry));
+  if (!region) {
+    return nullptr;
+  }
+  return region
+      ->chunks[(cy - ry * REGION_SIZE) * REGION_SIZE + (cx - rx * REGION_SIZE)]
+      .get();
+}
+
+void TileWorld::setChunk(int32_t cx, int32_t cy, TileChunk &&chunk) {
+  auto rx = floorDiv(cx, REGION_SIZE);
+  auto ry = floorDiv(cy, REGION_SIZE);
+  auto region = acquireRegion(makeKey(rx, ry));
+  region->chunks[(cy - ry * REGION_SIZE) * REGION_SIZE +
+                 (cx - rx * REGION_SIZE)] =
+      chunk.isEmpty() ? getEmptyChunk()
+                      : std::make_shared<TileChunk>(std::move(chunk));
+  region->dirty = true;
+}
+
+bool TileWorld::loadChunk(int32_t cx, int32_t cy, TileChunk &&chunk,
+                          uint64_t revision) {
+  auto rx = floorDiv(cx, REGION_SIZE);
+  auto ry = floorDiv(cy, REGION_SIZE);
+  auto region = acquireRegion(makeKey(rx, ry));
+  auto &slot = region->chunks[(cy - ry * REGION_SIZE) * REGION_SIZE +
+                              (cx - rx * REGION_SIZE)];
+  if (slot != getEmptyChunk() && slot->getRevision() > revision) {
+    return false;
+  }
+  slot = chunk.isEmpty() ? getEmptyChunk()
+                         : std::make_shared<TileChunk>(std::move(chunk));
+  region->dirty = true;
+  return true;
+}
+
+static void appendChunks(std::vector<TileWorld::ChunkRecord> &records,
+                         uint64_t key,
+                         const std::vector<std::shared_ptr<TileChunk>> &chunks,
+                         uint64_t mask, bool changes) {
+  auto rx = static_cast<int32_t>(key >> 32);
+  auto ry = static_cast<int32_t>(key & 0xffffffff);
+  for (int32_t index = 0;
+       index < TileWorld::REGION_SIZE * TileWorld::REGION_SIZE; ++index) {
+    auto &chunk = chunks[index];
+    if ((mask >> index & 1) && (changes || !chunk->isEmpty())) {
+      records.push_back({rx * TileWorld::REGION_SIZE +
+                             index % TileWorld::REGION_SIZE,
+                         ry * TileWorld::REGION_SIZE +
+                             index / TileWorld::REGION_SIZE,
+                         chunk});
+    }
+  }
+}
+
+TileWorld::Snapshot TileWorld::snapshot(bool changes) {
+  PROFILE_ZONE("TileWorld::snapshot");
+  collect();
+  Snapshot snapshot;
+  snapshot.changes = changes;
+  auto getMask = [&](uint64_t key, const Region &region) -> uint64_t {
+    if (!changes) {
+      return UINT64_MAX;
+    }
+    auto it = _changed.find(key);
+    return region.changed | (it != _changed.end() ? it->second : 0);
+  };
+  std::unordered_set<uint64_t> visited;
+  for (auto &[key, region] : _regions) {
+    visited.insert(key);
+    appendChunks(snapshot.chunks, key, region->chunks, getMask(key, *region),
+                 changes);
+  }
+  for (auto &[key, region] : _writeBack) {
+    if (visited.insert(key).second) {
+      appendChunks(snapshot.chunks, key, region->chunks,
+                   getMask(key, *region), changes);
+    }
+  }
+  std::vector<std::pair<uint64_t, uint64_t>> paged;
+  if (changes) {
+    for (auto &[key, mask] : _changed) {
+      if (!visited.contains(key)) {
+        paged.push_back({key, mask});
+      }
+    }
+  } else if (!_path.empty()) {
+    for (auto &entry : std::filesystem::directory_iterator(_path)) {
+      auto name = entry.path().filename().string();
+      int32_t rx = 0;
+      int32_t ry = 0;
+      if (name.ends_with(".region") &&
+          std::sscanf(name.c_str(), "%d.%d.region", &rx, &ry) == 2 &&
+          !visited.contains(makeKey(rx, ry))) {
+        paged.push_back({makeKey(rx, ry), UINT64_MAX});
+      }
+    }
+  }
+  clearChanges();
+  // Paged-out regions are linked rather than read, so the caller only pays
+  // for the directory walk.
+  static std::atomic<uint64_t> snapshots = 0;
+  auto suffix = std::format(".snapshot{}", ++snapshots);
+  for (auto &[key, mask] : paged) {
+    auto path = getRegionPath(key);
+    std::error_code error;
+    std::filesystem::create_hard_link(path, path + suffix, error);
+    if (!error) {
+      snapshot.paged.push_back({path + suffix, mask});
+      continue;
+    }
+    Region region;
+    if (!readRegion(path, region)) {
+      _logger->error("Failed to read region '{}': {}", path, SDL_GetError());
+      continue;
+    }
+    appendChunks(snapshot.chunks, key, region.chunks, mask, changes);
+  }
+  return snapshot;
+}
+
+void TileWorld::clearChanges() {
+  _changed.clear();
+  for (auto &[_, region] : _regions) {
+    region->changed = 0;
+  }
+  for (auto &[_, region] : _writeBack) {
+    region->changed = 0;
+  }
+}
+
+TileWorld::Snapshot::~Snapshot() {
+  for (auto &region : paged) {
+    std::error_code error;
+    std::filesystem::remove(region.path, error);
+  }
+}
+
+bool TileWorld::loadPaged(Snapshot &snapshot) {
+  while (!snapshot.paged.empty()) {
+    auto &[path, mask] = snapshot.paged.back();
+    auto name = std::filesystem::path(path).filename().string();
+    int32_t rx = 0;
+    int32_t ry = 0;
+    Region region;
+    if (std::sscanf(name.c_str(), "%d.%d.region", &rx, &ry) != 2 ||
+        !readRegion(path, region)) {
+      return false;
+    }
+    appendChunks(snapshot.chunks, makeKey(rx, ry), region.chunks, mask,
+                 snapshot.changes);
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    snapshot.paged.pop_back();
+  }
+  return true;
+}
+
+void TileWorld::update(int32_t x, int32_t y, int32_t w, int32_t h) {
+  PROFILE_ZONE("TileWorld::update");
+  _frame++;
+  collect();
+  if (_path.empty()) {
+    return;
+  }
+  int32_t prefetch = static_cast<int32_t>(_prefetch);
+  auto left = floorDiv(x, REGION_TILES) - prefetch;
+  auto top = floorDiv(y, REGION_TILES) - prefetch;
+  auto right = floorDiv(x + std::max(w, 1) - 1, REGION_TILES) + prefetch;
+  auto bottom = floorDiv(y + std::max(h, 1) - 1, REGION_TILES) + prefetch;
+  std::unordered_set<uint64_t> keep;
+  for (auto ry = top; ry <= bottom; ++ry) {
+    for (auto rx = left; rx <= right; ++rx) {
+      auto key = makeKey(rx, ry);
+      keep.insert(key);
+      auto it = _regions.find(key);
+      if (it != _regions.end()) {
+        it->second->lastUsed = _frame;
+      } else if (_writeBack.contains(key)) {
+        acquireRegion(key);
+      } else {
+        requestLoad(key);
+      }
+    }
+  }
+  evict(keep);
+}
+
+void TileWorld::flush() {
+  if (!_io) {
+    return;
+  }
+  _io->wait();
+  collect();
+  for (auto &[key, region] : _regions) {
+    if (!region->dirty) {
+      continue;
+    }
+    auto path = getRegionPath(key);
+    if (!writeRegion(path, *region)) {
+      _logger->error("Failed to write region '{}': {}", path, SDL_GetError());
+      continue;
+    }
+    region->dirty = false;
+  }
+}
+
+void TileWorld::reset() {
+  if (_io) {
+    _io->wait();
+  }
+  collect();
+  _regions.clear();
+  _writeBack.clear();
+  _changed.clear();
+  _lastKey = UINT64_MAX;
+  _lastRegion = nullptr;
+  if (_path.empty()) {
+    return;
+  }
+  std::error_code error;
+  for (auto &entry : std::filesystem::directory_iterator(_path, error)) {
+    auto name = entry.path().filename().string();
+    if (name.ends_with(".region") || name.ends_with(".region.tmp")) {
+      std::filesystem::remove(entry.path(), error);
+    }
+  }
+}